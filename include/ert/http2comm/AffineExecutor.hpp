@@ -0,0 +1,142 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ert/http2comm/Executor.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * Executor with a dedicated worker group and queue (queue dispatcher) per nghttp2 io thread.
+ *
+ * The shard is selected by the dispatching io thread (io threads are bound to shards in round
+ * robin on their first dispatch), so streams from one io thread are always processed by the same
+ * worker group, keeping the round trip (io thread, worker, io thread) within one shard instead of
+ * crossing a single shared queue. So, the number of shards should be the number of nghttp2 io
+ * threads provided on Http2Server::serve().
+ *
+ * Congestion control (see Executor::congested()) is checked on the shard of the dispatching thread,
+ * so an overloaded shard is detected even when the others are idle.
+ *
+ * Metrics report the queue size and busy threads of every shard (labeled by 'shard'), sampled
+ * periodically by a dedicated thread (also when a shard drains or stops receiving traffic), so
+ * imbalance between shards is visible.
+ */
+class AffineExecutor : public Executor
+{
+    struct Shard {
+        std::unique_ptr<ert::queuedispatcher::QueueDispatcher> queue_dispatcher;
+        ert::metrics::gauge_t *size_gauge{};
+        ert::metrics::gauge_t *busy_threads_gauge{};
+    };
+
+    const std::uint64_t id_;
+    std::vector<Shard> shards_{};
+    std::atomic<std::size_t> next_shard_{};
+    std::atomic<bool> metrics_{};
+
+    // Metrics sampling:
+    const std::chrono::milliseconds sampling_period_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopped_{}; // protected by mutex
+    std::thread sampler_{};
+
+    std::size_t shardIndex();
+    void sample();
+
+public:
+    /**
+    * Class constructor
+    *
+    * @param name Name prefix for shards queue dispatchers
+    * @param shards Number of shards (nghttp2 io threads)
+    * @param threadsPerShard Number of worker threads for every shard
+    * @param maxThreadsPerShard Maximum number of worker threads for every shard. Defaults to '0' (same than threadsPerShard)
+    * @param samplingPeriod Shards metrics sampling period (when metrics are enabled). Defaults to 100 milliseconds
+    */
+    AffineExecutor(const std::string &name, std::size_t shards, std::size_t threadsPerShard, std::size_t maxThreadsPerShard = 0,
+                   std::chrono::milliseconds samplingPeriod = std::chrono::milliseconds(100));
+
+    /**
+    * Class destructor: metrics sampling thread is stopped
+    */
+    ~AffineExecutor();
+
+    void dispatch(std::shared_ptr<ert::queuedispatcher::StreamIf> stream) override;
+    int getBusyThreads() const override; // all shards
+    int getThreads() const override; // all shards
+    int getSize() const override; // all shards
+    bool congested(int queueMaxSize, unsigned int priority) override; // dispatching thread shard
+    void enableMetrics(ert::metrics::Metrics *metrics, const std::string &name, const std::string &source) override;
+
+    /**
+    * Gets the number of shards
+    */
+    std::size_t getShards() const {
+        return shards_.size();
+    }
+
+    /**
+    * Gets the busy threads of a shard
+    */
+    int getShardBusyThreads(std::size_t shard) const;
+
+    /**
+    * Gets the queue size of a shard
+    */
+    int getShardSize(std::size_t shard) const;
+};
+
+}
+}
@@ -0,0 +1,157 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <ert/http2comm/Executor.hpp>
+
+#include <ert/metrics/Metrics.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * Autoscaler configuration (see Autoscaler)
+ */
+struct AutoscalerConfig {
+    std::chrono::milliseconds period{100}; // evaluation period
+    std::chrono::microseconds scale_up_queue_delay{1000}; // average queueing delay to scale up
+    std::chrono::microseconds scale_down_queue_delay{100}; // average queueing delay to scale down
+    double scale_up_busy_ratio{0.9}; // average busy threads ratio to scale up
+    double scale_down_busy_ratio{0.5}; // average busy threads ratio to scale down
+    unsigned int scale_down_periods{10}; // consecutive periods under scale down thresholds
+    std::size_t step{1}; // threads added or removed on every scaling event
+};
+
+/**
+ * Worker threads autoscaler: adjusts the active threads of an executor (see Executor::setActiveThreads())
+ * within a range, from the queueing delay observed for every processed stream and the busy threads ratio.
+ *
+ * Every period, the average queueing delay and the average busy ratio (sampled ten times per period)
+ * are evaluated: when any of them is over its scale up threshold, active threads are increased at once.
+ * Threads are only decreased when both are under their scale down thresholds along a number of
+ * consecutive periods (hysteresis), so the pool does not oscillate with bursty traffic.
+ */
+class Autoscaler
+{
+    Executor &executor_;
+    const std::size_t min_threads_;
+    const std::size_t max_threads_;
+    const AutoscalerConfig config_;
+    std::atomic<std::size_t> target_threads_;
+
+    // Queueing delay observations along current period:
+    std::atomic<std::uint64_t> queue_delay_sum_us_{};
+    std::atomic<std::uint64_t> queue_delay_count_{};
+
+    // Evaluation state (autoscaler thread):
+    double busy_ratio_sum_{};
+    unsigned int busy_ratio_samples_{};
+    unsigned int calm_periods_{};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopped_{}; // protected by mutex
+    std::thread thread_{};
+
+    // metrics:
+    std::atomic<bool> metrics_{};
+    ert::metrics::gauge_t *target_threads_gauge_ptr_{};
+    ert::metrics::counter_t *scale_up_counter_ptr_{};
+    ert::metrics::counter_t *scale_down_counter_ptr_{};
+
+    void run();
+    void evaluate();
+    void scale(std::size_t threads, bool up);
+
+public:
+    /**
+    * Class constructor. Executor active threads are set to the minimum.
+    *
+    * @param executor Executor to scale (must support Executor::setActiveThreads() and outlive the autoscaler)
+    * @param minThreads Minimum number of active threads
+    * @param maxThreads Maximum number of active threads
+    * @param config Autoscaling configuration
+    */
+    Autoscaler(Executor &executor, std::size_t minThreads, std::size_t maxThreads, const AutoscalerConfig &config = AutoscalerConfig());
+
+    /**
+    * Class destructor: evaluation thread is stopped
+    */
+    ~Autoscaler();
+
+    /**
+    * Observes the queueing delay of a stream (called from worker threads)
+    *
+    * @param queueDelay Delay between stream dispatch and processing
+    */
+    void observe(const std::chrono::microseconds &queueDelay) {
+        queue_delay_sum_us_.fetch_add(queueDelay.count(), std::memory_order_relaxed);
+        queue_delay_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+    * Gets the current target of active threads
+    */
+    std::size_t getTargetThreads() const {
+        return target_threads_.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * Enables metrics: target threads gauge and scaling events counter (labeled by 'direction')
+    *
+    * @param metrics Metrics instance
+    * @param name Families name prefix (server name)
+    * @param source 'source' label value
+    */
+    void enableMetrics(ert::metrics::Metrics *metrics, const std::string &name, const std::string &source);
+};
+
+}
+}
@@ -0,0 +1,103 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * Decaying percentile estimator for message body sizes.
+ *
+ * It is used to reserve body memory in size classes (powers of two) derived from the recent
+ * traffic, instead of the largest size ever seen: a single huge message only moves the estimate
+ * one step, and the estimate decays again with the following messages. The estimation follows a
+ * multiplicative stochastic approximation which converges where a 'percentile' fraction of the
+ * observations are below the estimate.
+ *
+ * Updates are lock-free plain stores: concurrent updates may be lost, which is harmless for an
+ * estimation and avoids read-modify-write contention on the hot path.
+ */
+class BodySizeEstimator
+{
+    const double percentile_;
+    const double step_;
+    std::atomic<double> estimate_;
+
+public:
+    /**
+    * Minimum size class (smaller reservations are not worth it)
+    */
+    static constexpr std::size_t MinSizeClass = 256;
+
+    /**
+    * Class constructor
+    *
+    * @param percentile Percentile estimated, 0.95 by default
+    * @param step Relative step per observation, 0.02 by default (higher values adapt faster but fluctuate more)
+    */
+    explicit BodySizeEstimator(double percentile = 0.95, double step = 0.02);
+
+    /**
+    * Registers a body size
+    *
+    * @param size Body size observed (zero sizes should not be registered)
+    */
+    void observe(std::size_t size);
+
+    /**
+    * Gets the current estimation
+    */
+    double getEstimate() const {
+        return estimate_.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * Gets the size class (power of two, not lower than MinSizeClass) for the current estimation
+    */
+    std::size_t getSizeClass() const;
+};
+
+}
+}
@@ -0,0 +1,176 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <ert/queuedispatcher/StreamIf.hpp>
+#include <ert/queuedispatcher/QueueDispatcher.hpp>
+#include <ert/metrics/Metrics.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * Executor abstraction used by the server to move streams processing out of the nghttp2 io threads.
+ *
+ * Streams are dispatched from nghttp2 io threads, and the executor must call their process()
+ * method from its own threads, passing the busy state of the workers and the queue size as
+ * seen at processing time.
+ */
+class Executor
+{
+public:
+    virtual ~Executor() {}
+
+    /**
+    * Dispatches a stream to be processed (called from nghttp2 io threads)
+    *
+    * @param stream Stream to process
+    */
+    virtual void dispatch(std::shared_ptr<ert::queuedispatcher::StreamIf> stream) = 0;
+
+    /**
+    * Dispatches a stream with a priority class (called from nghttp2 io threads). Default
+    * implementation ignores the priority.
+    *
+    * @param stream Stream to process
+    * @param priority Priority class, being zero the highest one (see getPriorities())
+    */
+    virtual void dispatch(std::shared_ptr<ert::queuedispatcher::StreamIf> stream, unsigned int priority) {
+        dispatch(std::move(stream));
+    }
+
+    /**
+    * Gets the number of priority classes supported. Default implementation has only one (FIFO).
+    */
+    virtual unsigned int getPriorities() const {
+        return 1;
+    }
+
+    /**
+    * Gets the number of busy worker threads
+    */
+    virtual int getBusyThreads() const = 0;
+
+    /**
+    * Gets the number of worker threads (active ones when the executor supports setActiveThreads())
+    */
+    virtual int getThreads() const = 0;
+
+    /**
+    * Sets the number of active worker threads (see Autoscaler). Default implementation does not
+    * support it.
+    *
+    * @param threads Number of active worker threads (limited by the executor threads)
+    *
+    * @return Boolean about support
+    */
+    virtual bool setActiveThreads(std::size_t threads) {
+        return false;
+    }
+
+    /**
+    * Gets the number of streams pending to be processed
+    */
+    virtual int getSize() const = 0;
+
+    /**
+    * Gets the number of streams which would be processed before a new one dispatched with the
+    * provided priority (used by congestion control). Default implementation returns getSize().
+    *
+    * @param priority Priority class
+    */
+    virtual int getSizeAhead(unsigned int priority) const {
+        return getSize();
+    }
+
+    /**
+    * Checks congestion for a new stream dispatched from the calling thread with the provided priority
+    * (called from nghttp2 io threads on admission control): no idle workers and more than the maximum
+    * size ahead. Default implementation checks the whole executor.
+    *
+    * @param queueMaxSize Maximum number of streams ahead
+    * @param priority Priority class
+    */
+    virtual bool congested(int queueMaxSize, unsigned int priority) {
+        return (getBusyThreads() >= getThreads() && getSizeAhead(priority) > queueMaxSize);
+    }
+
+    /**
+    * Enables executor specific metrics (called from Http2Server::enableMetrics()). Default implementation
+    * has no metrics.
+    *
+    * @param metrics Metrics instance
+    * @param name Families name prefix (server name)
+    * @param source 'source' label value
+    */
+    virtual void enableMetrics(ert::metrics::Metrics *metrics, const std::string &name, const std::string &source) {}
+};
+
+/**
+ * Executor implemented by the queue dispatcher library (single shared FIFO queue), which is
+ * the default server executor.
+ */
+class QueueDispatcherExecutor : public Executor
+{
+    std::unique_ptr<ert::queuedispatcher::QueueDispatcher> queue_dispatcher_;
+
+public:
+    /**
+    * Class constructor
+    *
+    * @param name Queue dispatcher name
+    * @param threads Number of worker threads
+    * @param maxThreads Maximum number of worker threads which processing could grow to. Defaults to '0' (same than threads)
+    */
+    QueueDispatcherExecutor(const std::string &name, std::size_t threads, std::size_t maxThreads = 0);
+
+    void dispatch(std::shared_ptr<ert::queuedispatcher::StreamIf> stream) override;
+    int getBusyThreads() const override;
+    int getThreads() const override;
+    int getSize() const override;
+};
+
+}
+}
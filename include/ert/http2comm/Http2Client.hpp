@@ -49,6 +49,9 @@ SOFTWARE.
 #include <nghttp2/asio_http2.h>
 
 #include <ert/http2comm/Http2Connection.hpp>
+#include <ert/http2comm/MetricsCache.hpp>
+#include <ert/http2comm/ShardedMetrics.hpp>
+#include <ert/http2comm/MetricsSampler.hpp>
 
 #include <ert/metrics/Metrics.hpp>
 
@@ -105,6 +108,7 @@ private:
         std::chrono::microseconds receptionUs;
         std::atomic<bool> cb_invoked = false;
         std::atomic<bool> timed_out = false;
+        bool sampled{}; // for metrics
     };
 
     // Metric names should be in lowercase and separated by underscores (_).
@@ -135,6 +139,26 @@ private:
     ert::metrics::bucket_boundaries_t response_delay_seconds_histogram_bucket_boundaries_;
     ert::metrics::bucket_boundaries_t message_size_bytes_histogram_bucket_boundaries_; // both received/sent (simplification)
 
+    // Handles resolved once by method (and status code), to avoid labels building on every update:
+    struct SentMessageMetrics {
+        ert::metrics::counter_t *observed_counter;
+        ert::metrics::gauge_t *size_bytes_gauge;
+        ert::metrics::histogram_t *size_bytes_histogram;
+    };
+    struct ResponseMetrics {
+        ert::metrics::counter_t *observed_counter;
+        ert::metrics::gauge_t *delay_seconds_gauge;
+        ert::metrics::histogram_t *delay_seconds_histogram;
+        ert::metrics::gauge_t *size_bytes_gauge;
+        ert::metrics::histogram_t *size_bytes_histogram;
+    };
+    std::unique_ptr<MetricsCache<SentMessageMetrics>> sent_messages_metrics_{};
+    std::unique_ptr<MetricsCache<ert::metrics::counter_t*>> requests_unsents_counters_{};
+    std::unique_ptr<MetricsCache<ert::metrics::counter_t*>> responses_timedout_counters_{};
+    std::unique_ptr<MetricsCache<ResponseMetrics>> responses_metrics_{};
+    std::unique_ptr<ShardedMetrics> sharded_metrics_{};
+    MetricsSampler metrics_sampler_{};
+
     std::atomic<std::uint64_t> reception_id_{};
     std::atomic<std::size_t> maximum_request_body_size_{};
 
@@ -196,10 +220,18 @@ public:
     *  - h2agentB_myClientToA
     *  - udp_server_h2client[_myClientToA]: optional endpoint identifier as could be inferred from process name, because
     *                                       'udp-server-h2client' application has only one client
+    *
+    *  @param shardedMetricsMergePeriod Optional period to merge counters and histograms accumulated per thread (see ShardedMetrics).
+    *  This avoids cache lines contention when many threads update the same instances, at the cost of delaying scraped values up
+    *  to this period (keep it shorter than scrape interval). Defaults to zero, which means direct updates.
+    *  @param samplingRate Optional sampling for delay and size histograms and gauges: only one of every 'samplingRate' transactions is
+    *  observed (randomly chosen). Counters are always exact. Defaults to 1 (no sampling).
     */
     void enableMetrics(ert::metrics::Metrics *metrics,
                        const ert::metrics::bucket_boundaries_t &responseDelaySecondsHistogramBucketBoundaries = {},
-                       const ert::metrics::bucket_boundaries_t &messageSizeBytesHistogramBucketBoundaries = {}, const std::string &source = "");
+                       const ert::metrics::bucket_boundaries_t &messageSizeBytesHistogramBucketBoundaries = {}, const std::string &source = "",
+                       const std::chrono::milliseconds &shardedMetricsMergePeriod = std::chrono::milliseconds::zero(),
+                       unsigned int samplingRate = 1);
 
     /**
      * Send request to the server (async)
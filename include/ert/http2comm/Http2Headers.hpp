@@ -55,7 +55,7 @@ namespace http2comm
  *
  * @param headers nghttp2 headers map
  *
- * @return sorted query parameters URI part
+ * @return headers string representation
  */
 std::string headersAsString(const nghttp2::asio_http2::header_map &headers);
 
@@ -43,15 +43,32 @@ SOFTWARE.
 #include <memory>
 #include <chrono>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <limits>
 
 #include <boost/asio.hpp>
 
 #include <nghttp2/asio_http2_server.h>
 
 #include <ert/http2comm/Stream.hpp>
+#include <ert/http2comm/ResponseSource.hpp>
+#include <ert/http2comm/Router.hpp>
+#include <ert/http2comm/TimingWheel.hpp>
+#include <ert/http2comm/Executor.hpp>
+#include <ert/http2comm/Autoscaler.hpp>
 #include <ert/http2comm/Http2Headers.hpp>
+#include <ert/http2comm/QueueDelayLimiter.hpp>
+#include <ert/http2comm/MetricsCache.hpp>
+#include <ert/http2comm/ShardedMetrics.hpp>
+#include <ert/http2comm/MetricsSampler.hpp>
+#include <ert/http2comm/StreamPool.hpp>
+#include <ert/http2comm/BodySizeEstimator.hpp>
 
-#include <ert/queuedispatcher/QueueDispatcher.hpp>
 #include <ert/metrics/Metrics.hpp>
 
 namespace ert
@@ -61,6 +78,7 @@ namespace http2comm
 
 class Http2Server
 {
+    const std::uint64_t instance_id_;
     std::string server_key_password_{};
     // Metric names should be in lowercase and separated by underscores (_).
     // Metric names should start with a letter or an underscore (_).
@@ -68,14 +86,96 @@ class Http2Server
     // Metric names should not be too long or too short.
     std::string api_name_{};
     std::string api_version_{};
+    std::string api_path_{}; // cached on setters
+    void updateApiPath();
+    Router router_{};
     boost::asio::io_context *timers_io_context_;
-    std::unique_ptr<ert::queuedispatcher::QueueDispatcher> queue_dispatcher_;
+
+    // Body sizes statistics (used by streams on recycle, so declared before the stream pools):
+    BodySizeEstimator request_body_size_estimator_{};
+    BodySizeEstimator response_body_size_estimator_{};
+
+    // Static routes table (path -> method responses). Replaced as a whole on every update (copy on write),
+    // so nghttp2 io threads only reload their snapshot when the version changes:
+    struct StaticResponse {
+        unsigned int status_code;
+        std::shared_ptr<const nghttp2::asio_http2::header_map> headers;
+        std::shared_ptr<const std::string> body;
+    };
+    typedef std::unordered_map<std::string, std::vector<std::pair<std::string, StaticResponse>>> static_routes_t;
+    std::mutex static_routes_mutex_; // serializes writers
+    std::shared_ptr<const static_routes_t> static_routes_{}; // nullptr when empty
+    std::atomic<std::uint64_t> static_routes_version_{};
+    void updateStaticRoutes(std::shared_ptr<const static_routes_t> routes);
+
+    // State owned by every nghttp2 io thread. Stream pools must outlive the streams, so this is declared
+    // before the members which may hold them (also released explicitly on destruction):
+    struct IoThreadContext {
+        std::thread::id thread_id;
+        std::shared_ptr<StreamPool> stream_pool;
+        std::uint64_t static_routes_version{};
+        std::shared_ptr<const static_routes_t> static_routes{};
+    };
+    std::mutex io_thread_contexts_mutex_;
+    std::vector<std::unique_ptr<IoThreadContext>> io_thread_contexts_{};
+    IoThreadContext &ioThreadContext();
+
+    // Response delays, sharded by reception identifier (one timing wheel per timers io context):
+    std::vector<std::unique_ptr<TimingWheel>> timing_wheels_{};
+    TimingWheel *timingWheel(const std::uint64_t &receptionId) const {
+        return timing_wheels_.empty() ? nullptr : timing_wheels_[receptionId % timing_wheels_.size()].get();
+    }
+
+    // Held responses (responseDelayMs() returning HoldResponse) by reception identifier, until release():
+    struct HeldStreams {
+        std::mutex mutex;
+        std::unordered_map<std::uint64_t, std::shared_ptr<Stream>> streams;
+    };
+    static constexpr std::size_t HeldStreamsShards = 16;
+    std::array<HeldStreams, HeldStreamsShards> held_streams_{};
+    void hold(std::shared_ptr<Stream> stream);
+    std::shared_ptr<Stream> unhold(const std::uint64_t &receptionId);
+
+    // Timers io contexts owned (createTimersIoContexts()):
+    std::vector<std::unique_ptr<boost::asio::io_context>> owned_timers_io_contexts_{};
+    std::vector<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> owned_timers_work_guards_{};
+    std::vector<std::thread> owned_timers_threads_{};
+    void stopOwnedTimersIoContexts(); // also releases timing wheels
+    void assignTimersIoContexts(const std::vector<boost::asio::io_context*> &ioContexts);
+    std::unique_ptr<Executor> executor_; // queue dispatcher by default
+    std::size_t worker_threads_{};
+    std::size_t max_worker_threads_{};
+    std::unique_ptr<Autoscaler> autoscaler_{}; // default executor (destroyed before it)
     int queue_dispatcher_max_size_{};
+    std::unique_ptr<QueueDelayLimiter> queue_delay_limiter_{};
+
+    // Bulkheads (separate executors for selected methods and paths, see addBulkhead()):
+    struct Bulkhead {
+        std::string name;
+        std::unique_ptr<Executor> executor;
+        int queue_max_size;
+        std::unique_ptr<QueueDelayLimiter> queue_delay_limiter;
+        std::vector<std::pair<std::string, std::string>> rules; // method and path prefix (empty for any)
+    };
+    std::vector<std::unique_ptr<Bulkhead>> bulkheads_{};
+
+    // Header carrying the priority class, and class for requests without it (see priority()):
+    std::string priority_header_{};
+    unsigned int default_priority_{LowestPriority};
 #ifdef H2COMM_MAX_CONCURRENT_STREAMS
     uint32_t max_concurrent_streams_{};
 #endif
 
+    // Prebuilt congestion response (built at serve()), sent from nghttp2 io threads on admission control:
+    nghttp2::asio_http2::header_map congestion_response_headers_{};
+    std::string congestion_response_body_{};
+
+
     nghttp2::asio_http2::server::request_cb handler();
+    void buildCongestionResponse();
+    bool congestion(Executor *executor, int queueMaxSize, unsigned int priority) const;
+    bool queueDelayDrop(QueueDelayLimiter *limiter, const std::chrono::microseconds &sojourn);
+    const StaticResponse *findStaticRoute(IoThreadContext &context, const nghttp2::asio_http2::server::request &req);
 
     // metrics:
     ert::metrics::Metrics *metrics_{};
@@ -99,8 +199,52 @@ class Http2Server
     ert::metrics::bucket_boundaries_t response_delay_seconds_histogram_bucket_boundaries_;
     ert::metrics::bucket_boundaries_t message_size_bytes_histogram_bucket_boundaries_; // both received/sent (simplification)
 
+    // Handles resolved once by method (and status/error code), to avoid labels building on every update:
+    struct ReceivedMessageMetrics {
+        ert::metrics::gauge_t *size_bytes_gauge;
+        ert::metrics::histogram_t *size_bytes_histogram;
+    };
+    struct ResponseMetrics {
+        ert::metrics::counter_t *observed_counter;
+        ert::metrics::gauge_t *delay_seconds_gauge;
+        ert::metrics::gauge_t *size_bytes_gauge;
+        ert::metrics::histogram_t *delay_seconds_histogram;
+        ert::metrics::histogram_t *size_bytes_histogram;
+    };
+    std::unique_ptr<MetricsCache<ert::metrics::counter_t*>> requests_accepted_counters_{};
+    std::unique_ptr<MetricsCache<ert::metrics::counter_t*>> requests_errored_counters_{};
+    std::unique_ptr<MetricsCache<ReceivedMessageMetrics>> received_messages_metrics_{};
+    std::unique_ptr<MetricsCache<ResponseMetrics>> status_code_responses_metrics_{};
+    std::unique_ptr<MetricsCache<ResponseMetrics>> error_code_responses_metrics_{};
+    std::unique_ptr<MetricsCache<ResponseMetrics>> createResponseMetricsCache(const std::string &resultCodeLabel);
+    std::unique_ptr<ShardedMetrics> sharded_metrics_{};
+    MetricsSampler metrics_sampler_{};
+
+    // Stream pool (only 'source' and 'result' labels, so resolved once):
+    ert::metrics::counter_t *stream_pool_hits_counter_ptr_{};
+    ert::metrics::counter_t *stream_pool_misses_counter_ptr_{};
+
+    // Requests discarded before processing because the stream was already reset (only 'source' label, so resolved once):
+    ert::metrics::counter_t *requests_discarded_counter_ptr_{};
+
+    // Queue delay limiters (default executor and bulkheads), sampled periodically out of the processing path,
+    // as the limit also changes along intervals without traffic (only 'source' label, so resolved once):
+    struct QueueDelayLimiterMetrics {
+        QueueDelayLimiter *limiter;
+        ert::metrics::gauge_t *limit_seconds_gauge;
+        ert::metrics::counter_t *dropped_requests_counter;
+        std::uint64_t dropped; // already counted
+    };
+    std::mutex queue_delay_sampler_mutex_;
+    std::condition_variable queue_delay_sampler_cv_;
+    std::vector<QueueDelayLimiterMetrics> queue_delay_limiters_metrics_{}; // protected by mutex
+    bool queue_delay_sampler_stopped_{}; // protected by mutex
+    std::thread queue_delay_sampler_{};
+    void addQueueDelayLimiterMetrics(QueueDelayLimiter *limiter, const std::string &name);
+    void sampleQueueDelayLimiters();
+    void stopQueueDelaySampler();
+
     std::atomic<std::uint64_t> reception_id_{};
-    std::atomic<std::size_t> maximum_request_body_size_{};
 
 protected:
 
@@ -123,29 +267,74 @@ public:
     *
     * @param workerThreads number of worker threads.
     * @param maxWorkerThreads number of maximum worker threads which internal processing could grow to. Defaults to '0' which means that maximum equals to provided worker threads.
-    * @param timerIoContext Optional io context to manage response delays
+    * @param timerIoContext Optional io context to manage response delays. Delays are scheduled on a hierarchical timing wheel
+    * (see TimingWheel) driven from this io context, so scheduling and cancellation costs do not depend on the number of delayed responses.
     * @param queueDispatcherMaxSize This library implements a simple congestion control algorithm which will indicate congestion status when queue dispatcher (when used) has no
     * idle consumer threads, and queue dispatcher size is over this value. Defaults to -1 which means 'no limit' to grow the queue (this probably implies response time degradation).
-    * So, to enable the described congestion control algorithm, provide a non-negative value.
+    * So, to enable the described congestion control algorithm, provide a non-negative value. Admission is decided on the nghttp2 io thread once the request
+    * is completely received, so rejected streams are answered with a prebuilt SERVICE_UNAVAILABLE response and never enter the queue.
+    * @param queueDelayTarget Selects the adaptive congestion control (CoDel-style) based on the queueing delay measured for every stream between its
+    * dispatch and its processing by the queue dispatcher. When the standing delay along an interval (20 times the target) exceeds this target, streams
+    * waiting longer than the target are answered with SERVICE_UNAVAILABLE (and streams waiting longer than the interval are always dropped). This avoids
+    * hand-tuning the queue dispatcher maximum size per host and traffic profile (both algorithms may be combined anyway). Defaults to zero (disabled).
     */
-    Http2Server(const std::string& name, size_t workerThreads, size_t maxWorkerThreads = 0, boost::asio::io_context *timerIoContext = nullptr, int queueDispatcherMaxSize = -1 /* no limit */);
+    Http2Server(const std::string& name, size_t workerThreads, size_t maxWorkerThreads = 0, boost::asio::io_context *timerIoContext = nullptr, int queueDispatcherMaxSize = -1 /* no limit */,
+                const std::chrono::microseconds &queueDelayTarget = std::chrono::microseconds::zero() /* disabled */);
     virtual ~Http2Server();
 
     // setters
 
+    /**
+    * Sets the executor used to process streams out of the nghttp2 io threads, replacing the default one
+    * (queue dispatcher when worker threads are more than one). For example, WorkStealingExecutor could be
+    * more appropriate for bursty traffic on hosts with many cores. Must be called before serve(), and
+    * disables autoscaling (see enableAutoscaling()).
+    *
+    * @param executor Executor. Provide nullptr to process every stream on the nghttp2 io threads.
+    */
+    void setExecutor(std::unique_ptr<Executor> executor);
+
+    /**
+    * Enables autoscaling of default executor worker threads within [workerThreads, maxWorkerThreads] (see
+    * constructor), driven by the queueing delay of processed streams and the busy threads ratio (see
+    * Autoscaler). Executors not supporting active threads control (as the default queue dispatcher,
+    * which grows but never shrinks) are replaced by a single class PriorityExecutor with maxWorkerThreads
+    * threads. Must be called before serve(), and after setExecutor() if used.
+    *
+    * @param config Autoscaling configuration
+    *
+    * @return Boolean about success: maximum worker threads must be over worker threads, and a custom
+    * executor (setExecutor()) must support active threads control.
+    */
+    bool enableAutoscaling(const AutoscalerConfig &config = AutoscalerConfig());
+
+    /**
+    * Gets the autoscaler (nullptr when autoscaling is not enabled)
+    */
+    const Autoscaler *getAutoscaler() const {
+        return autoscaler_.get();
+    }
 
     /**
-    * Gets the queue dispatcher busy threads
+    * Gets the executor (nullptr when streams are processed on the nghttp2 io threads)
+    */
+    Executor *getExecutor() const {
+        return executor_.get();
+    }
+
+
+    /**
+    * Gets the queue dispatcher (executor) busy threads
     */
     int getQueueDispatcherBusyThreads() const;
 
     /**
-    * Gets the queue dispatcher number of scheduled threads
+    * Gets the queue dispatcher (executor) number of scheduled threads
     */
     int getQueueDispatcherThreads() const;
 
     /**
-    * Gets the queue dispatcher size
+    * Gets the queue dispatcher (executor) size
     */
     int getQueueDispatcherSize() const;
 
@@ -155,10 +344,32 @@ public:
     *
     * This enables a simple congestion control algorithm which consist in indicate congestion when
     * queue dispatcher has no idle consumer threads and also, queue size is over this specific
-    * value.
+    * value. Congested requests are rejected before being queued (see receiveError() note about
+    * SERVICE_UNAVAILABLE).
     */
     int getQueueDispatcherMaxSize() const;
 
+    /**
+    * Gets the queue delay limiter (adaptive congestion control), or nullptr when not configured
+    */
+    const QueueDelayLimiter *getQueueDelayLimiter() const {
+        return queue_delay_limiter_.get();
+    }
+
+    /**
+    * Gets the number of bulkheads
+    */
+    std::size_t getBulkheads() const {
+        return bulkheads_.size();
+    }
+
+    /**
+    * Gets the executor of a bulkhead (nullptr for unknown index, or when bulkhead is processed on the nghttp2 io threads)
+    *
+    * @param bulkhead Bulkhead index. Zero gets the default executor.
+    */
+    Executor *getBulkheadExecutor(std::size_t bulkhead) const;
+
     /**
     * Enable metrics
     *
@@ -171,10 +382,18 @@ public:
     *
     *  - h2agent[_traffic_server]: optional endpoint category, as it would be deducted from family name
     *  - h2agentB
+    *
+    *  @param shardedMetricsMergePeriod Optional period to merge counters and histograms accumulated per thread (see ShardedMetrics).
+    *  This avoids cache lines contention when many threads update the same instances, at the cost of delaying scraped values up
+    *  to this period (keep it shorter than scrape interval). Defaults to zero, which means direct updates.
+    *  @param samplingRate Optional sampling for delay and size histograms and gauges: only one of every 'samplingRate' transactions is
+    *  observed (randomly chosen). Counters are always exact. Defaults to 1 (no sampling).
     */
     void enableMetrics(ert::metrics::Metrics *metrics,
                        const ert::metrics::bucket_boundaries_t &responseDelaySecondsHistogramBucketBoundaries = {},
-                       const ert::metrics::bucket_boundaries_t &messageSizeBytesHistogramBucketBoundaries = {}, const std::string &source = "");
+                       const ert::metrics::bucket_boundaries_t &messageSizeBytesHistogramBucketBoundaries = {}, const std::string &source = "",
+                       const std::chrono::milliseconds &shardedMetricsMergePeriod = std::chrono::milliseconds::zero(),
+                       unsigned int samplingRate = 1);
 
     /**
     * Sets the server key password to use with TLS/SSL
@@ -190,6 +409,7 @@ public:
     void setApiName(const std::string& apiName)
     {
         api_name_ = apiName;
+        updateApiPath();
     }
 
     /**
@@ -198,8 +418,27 @@ public:
     void setApiVersion(const std::string& apiVersion)
     {
         api_version_ = apiVersion;
+        updateApiPath();
     }
 
+    /**
+    * Sets a pool of io contexts to manage response delays, instead of the one provided on construction.
+    * Delayed streams are sharded by reception identifier, each io context driving its own timing wheel,
+    * so delayed responses throughput scales with the number of io contexts (and threads running them).
+    * Must be called before serve().
+    *
+    * @param ioContexts Timers io contexts (run by the application)
+    */
+    void setTimersIoContexts(const std::vector<boost::asio::io_context*> &ioContexts);
+
+    /**
+    * Creates a pool of io contexts owned by the server (each one run by its own thread), to manage
+    * response delays as described in setTimersIoContexts(). Must be called before serve().
+    *
+    * @param number Number of io contexts (and threads)
+    */
+    void createTimersIoContexts(std::size_t number);
+
 #ifdef H2COMM_MAX_CONCURRENT_STREAMS
     /**
     * Sets the maximum number of concurrent HTTP/2 streams per connection.
@@ -212,12 +451,130 @@ public:
     }
 #endif
 
+    /**
+    * Adds (or replaces) a static route: requests with this method and path are answered directly
+    * from the nghttp2 io thread once completely received, with the provided response. They bypass
+    * the rest of the processing (checkMethodIsAllowed(), checkHeaders(), receive(), congestion
+    * control and queue dispatcher), which is the whole cost for simple mocks.
+    *
+    * Routes can be updated at runtime: the table is replaced atomically, and nghttp2 io threads
+    * never lock to read it.
+    *
+    * @param method Request method
+    * @param path Request uri path (exact match, query parameters are ignored)
+    * @param statusCode Response status code
+    * @param headers Response headers, sent as provided (so, include content-length if needed)
+    * @param body Response body
+    */
+    void addStaticRoute(const std::string &method, const std::string &path, unsigned int statusCode,
+                        const nghttp2::asio_http2::header_map &headers, const std::string &body);
+
+    /**
+    * Removes a static route
+    *
+    * @param method Request method
+    * @param path Request uri path
+    *
+    * @return Boolean about route existence
+    */
+    bool removeStaticRoute(const std::string &method, const std::string &path);
+
+    /**
+    * Removes every static route
+    */
+    void clearStaticRoutes();
+
+    /**
+    * Adds a route to the server router. When routes are added, reception is resolved by the router
+    * in one pass (method, API path prefix and route) instead of the virtual checkMethodIsAllowed(),
+    * checkMethodIsImplemented() and receive() chain. Error outcomes keep the precedence of that chain:
+    *
+    * - METHOD_NOT_ALLOWED (405) when the path matches a route but not the method (allowed methods are provided).
+    * - METHOD_NOT_IMPLEMENTED (501) for unknown methods (not matching any route path).
+    * - UNSUPPORTED_MEDIA_TYPE (415) when checkHeaders() fails.
+    * - WRONG_API_NAME_OR_VERSION (400) when the request path does not start with the API path (URLFunctions::matchPrefix()).
+    * - WRONG_URI (404) when no route matches the path.
+    *
+    * The only difference is that allowed methods are those of the matched route, instead of a server
+    * wide list: so, METHOD_NOT_ALLOWED can only be answered when the path is under the API path and
+    * matches some route.
+    *
+    * Routes must be added before serve().
+    *
+    * @param method Request method
+    * @param pattern Route pattern relative to the API path (if configured), with parameters as whole segments: '/users/{id}'
+    * @param handler Route handler (called from the same thread than receive() would be)
+    *
+    * @return Boolean about success (see Router::add())
+    */
+    bool addRoute(const std::string &method, const std::string &pattern, Router::handler_t handler) {
+        return router_.add(method, pattern, std::move(handler));
+    }
+
+    /**
+    * Adds a bulkhead: a separate executor with its own congestion control, so streams selected for it
+    * (see bulkhead()) can not starve the rest of traffic when saturated. For example, a route with large
+    * bodies and heavy validation may be isolated, so fast GET requests (health checks, queries) keep
+    * their latency. Bulkheads must be added before serve().
+    *
+    * @param name Bulkhead name, used as suffix for executor names and metric families
+    * @param workerThreads Number of worker threads (queue dispatcher executor)
+    * @param maxWorkerThreads Maximum number of worker threads. Defaults to '0' (same than worker threads)
+    * @param queueMaxSize Queue size for the simple congestion control algorithm (see getQueueDispatcherMaxSize()). Defaults to -1 (no limit)
+    * @param queueDelayTarget Queue delay target for the adaptive congestion control (see constructor). Defaults to zero (disabled)
+    *
+    * @return Bulkhead index (starting at 1, as '0' is reserved for the default executor)
+    */
+    std::size_t addBulkhead(const std::string &name, size_t workerThreads, size_t maxWorkerThreads = 0, int queueMaxSize = -1 /* no limit */,
+                            const std::chrono::microseconds &queueDelayTarget = std::chrono::microseconds::zero() /* disabled */);
+
+    /**
+    * Adds a bulkhead with the provided executor. Same than addBulkhead() but executor is given.
+    *
+    * @param name Bulkhead name, used as suffix for metric families
+    * @param executor Executor. Provide nullptr to process bulkhead streams on the nghttp2 io threads.
+    * @param queueMaxSize Queue size for the simple congestion control algorithm. Defaults to -1 (no limit)
+    * @param queueDelayTarget Queue delay target for the adaptive congestion control. Defaults to zero (disabled)
+    *
+    * @return Bulkhead index (starting at 1, as '0' is reserved for the default executor)
+    */
+    std::size_t addBulkhead(const std::string &name, std::unique_ptr<Executor> executor, int queueMaxSize = -1 /* no limit */,
+                            const std::chrono::microseconds &queueDelayTarget = std::chrono::microseconds::zero() /* disabled */);
+
+    /**
+    * Adds a selection rule for a bulkhead, evaluated by default bulkhead() implementation. Rules are
+    * evaluated in the order they were added, and first match wins. Must be called before serve().
+    *
+    * @param bulkhead Bulkhead index (returned by addBulkhead())
+    * @param method Request method. Empty for any method
+    * @param pathPrefix Request path prefix (whole segments, see URLFunctions::matchPrefix()). Empty for any path
+    *
+    * @return Boolean about success (false for unknown bulkhead index)
+    */
+    bool addBulkheadRule(std::size_t bulkhead, const std::string &method, const std::string &pathPrefix = "");
+
+    /**
+    * Sets the request header carrying the priority class, evaluated by default priority() implementation.
+    * Must be called before serve().
+    *
+    * @param name Header name (lowercase). Empty (default) to disable.
+    * @param defaultPriority Class for requests without a valid header value. Defaults to the lowest class,
+    * so unlabelled traffic never outranks labelled one (RFC 9218 default urgency would be '3').
+    */
+    void setPriorityHeader(const std::string &name, unsigned int defaultPriority = LowestPriority) {
+        priority_header_ = name;
+        default_priority_ = defaultPriority;
+    }
+
     // getters
 
     /**
     * Gets the API path (/<name>/<version>)
     */
-    std::string getApiPath() const;
+    const std::string &getApiPath() const
+    {
+        return (api_path_);
+    }
 
     /**
     * Gets the API name
@@ -236,14 +593,16 @@ public:
     }
 
     /**
-    * Virtual implementable definition of allowed methods
+    * Virtual implementable definition of allowed methods (not used when routes are added, although
+    * implementation is still mandatory)
     */
     virtual bool checkMethodIsAllowed(
         const nghttp2::asio_http2::server::request& req,
         std::vector<std::string>& allowedMethods) = 0;
 
     /**
-    * Virtual implementable definition of implemented methods
+    * Virtual implementable definition of implemented methods (not used when routes are added, although
+    * implementation is still mandatory)
     */
     virtual bool checkMethodIsImplemented(
         const nghttp2::asio_http2::server::request& req) = 0;
@@ -268,16 +627,65 @@ public:
         return true;
     }
 
+    /**
+    * Optional streaming reception of the request body. When this returns 'true' for a request,
+    * the body is not accumulated: it is delivered chunk by chunk, as received from nghttp2, through
+    * receiveHeaders(), receiveChunk() and receiveEnd(). This saves the body buffering (and copies)
+    * for large uploads, and allows applications to parse, hash or forward the chunks meanwhile the
+    * rest of the body is still being received.
+    *
+    * The usual processing goes on when the request is complete: receive() is called with an empty
+    * request body, so the application should correlate the streamed data by mean the request
+    * structure reference (which is the same along the stream life).
+    *
+    * @param req nghttp2-asio request structure (headers are available).
+    *
+    * @return Boolean about request body streaming. Default implementation returns 'false'.
+    */
+    virtual bool streamRequestBody(const nghttp2::asio_http2::server::request& req) {
+        return false;
+    }
+
+    /**
+    * Streaming reception: request headers received. Called from nghttp2 io thread, so it must
+    * not block.
+    *
+    * @param req nghttp2-asio request structure.
+    */
+    virtual void receiveHeaders(const nghttp2::asio_http2::server::request& req) {}
+
+    /**
+    * Streaming reception: request body chunk received. Called from nghttp2 io thread, so it must
+    * not block. Data is only valid along the call.
+    *
+    * @param req nghttp2-asio request structure.
+    * @param data chunk data.
+    * @param len chunk length.
+    */
+    virtual void receiveChunk(const nghttp2::asio_http2::server::request& req, const uint8_t* data, std::size_t len) {}
+
+    /**
+    * Streaming reception: request body completed. Called from nghttp2 io thread before the
+    * request is dispatched for processing. Note that this is never called when the stream is
+    * reset before completion (streamError() is called instead).
+    *
+    * @param req nghttp2-asio request structure.
+    */
+    virtual void receiveEnd(const nghttp2::asio_http2::server::request& req) {}
+
     /**
     * By default, memory to store request data is pre reserved to minimize possible reallocations
-    * when several chunks are received and then appended to the request body. The maximum request
-    * body size registered at a given moment is reserved by design.
+    * when several chunks are received and then appended to the request body. The reservation is
+    * done when the first chunk is received (so body-less requests never reserve), and its amount
+    * is the 'content-length' header value when present, or otherwise the size class (power of two)
+    * of a decaying percentile of the request body sizes recently observed (see BodySizeEstimator).
+    * As 'content-length' is untrusted, its reservation is limited to a few times that size class
+    * (16 KB at least), and larger bodies grow as data arrives.
     *
-    * Performance in general is better with this optimization, but specially with huge messages and
-    * low standard deviation of sizes registered. A mixed traffic profile with small messages has
-    * not such an obvious improvement although CPU consumption is not influenced by reservation
-    * amount. Instant memory requirements however, will be higher with the time until the largest
-    * message processed, but this is not a handicap under controlled environments.
+    * This keeps the single allocation benefit for large bodies, while the memory reserved under
+    * mixed traffic profiles is bounded: a single huge message does not inflate the reservation of
+    * the following ones. Recycled streams also release body buffers much larger than the current
+    * size class.
     *
     * As possible simplification, our server could delegate memory allocation to inner string
     * container (std::string append()) skipping the memory reservation done before appending data.
@@ -289,7 +697,54 @@ public:
     }
 
     /**
-    * Virtual reception callback. Implementation is mandatory.
+    * Inline processing selection. When queue dispatcher is used (more than one worker thread), every
+    * request is processed in a worker thread by default, which means a thread hop and a context switch
+    * per request. Applications may select cheap requests (those costing less than the hop itself) to be
+    * processed and answered directly on the nghttp2 io thread, while heavy ones still go to the queue
+    * dispatcher. Inline requests are not subject to the congestion control (they are not queued).
+    *
+    * Be careful: inline processing (receive() and the rest of virtual reception callbacks) blocks the
+    * nghttp2 io thread, so it must be really cheap and never block.
+    *
+    * @param req nghttp2-asio request structure (request is completely received).
+    *
+    * @return Boolean about inline processing. Default implementation returns 'false'.
+    */
+    virtual bool processInline(const nghttp2::asio_http2::server::request& req) {
+        return false;
+    }
+
+    /**
+    * Bulkhead selection (see addBulkhead()). Called from the nghttp2 io thread once the request is
+    * completely received, for requests not processed inline, so it must be cheap and never block.
+    *
+    * @param req nghttp2-asio request structure (request is completely received).
+    *
+    * @return Bulkhead index, or '0' for the default executor. Default implementation evaluates
+    * the rules added by addBulkheadRule().
+    */
+    virtual std::size_t bulkhead(const nghttp2::asio_http2::server::request& req);
+
+    /**
+    * Priority class selection, only evaluated when the selected executor supports more than one
+    * class (see PriorityExecutor). Called from the nghttp2 io thread once the request is completely
+    * received, so it must be cheap and never block.
+    *
+    * Congestion control by queue size (see getQueueDispatcherMaxSize()) only considers the streams
+    * queued ahead of the request priority class, so lower priority traffic is rejected first.
+    *
+    * @param req nghttp2-asio request structure (request is completely received).
+    *
+    * @return Priority class, being zero the highest one (values over the executor classes, as
+    * LowestPriority, are taken as the lowest class). Default implementation returns the value of the
+    * priority header (see setPriorityHeader()), either as a number or as the urgency of RFC 9218
+    * 'priority' field ('u=<n>'), and the default priority when missing, invalid or not configured.
+    */
+    virtual unsigned int priority(const nghttp2::asio_http2::server::request& req);
+
+    /**
+    * Virtual reception callback. Default implementation answers METHOD_NOT_IMPLEMENTED, so
+    * implementation is mandatory unless receiveSource() is implemented instead.
     *
     * @param receptionId server reception identifier (monotonically increased value in every reception, from 1 to N).
     * @param req nghttp2-asio request structure.
@@ -307,7 +762,39 @@ public:
                          unsigned int& statusCode,
                          nghttp2::asio_http2::header_map& headers,
                          std::string& responseBody,
-                         unsigned int &responseDelayMs) = 0;
+                         unsigned int &responseDelayMs);
+
+    /**
+    * Virtual reception callback which also allows to provide alternative sources for the response
+    * (a streaming generator, or shared immutable body and headers, see ResponseSource). When a body
+    * source is provided, the response body string is ignored, and the same applies to the headers
+    * map when shared headers are provided.
+    *
+    * Default implementation just calls receive(), so there is no need to implement this unless
+    * alternative sources are used.
+    *
+    * @param receptionId server reception identifier (monotonically increased value in every reception, from 1 to N).
+    * @param req nghttp2-asio request structure.
+    * @param requestBody request body received.
+    * @param receptionTimestampUs microseconds timestamp of reception.
+    * @param statusCode response status code to be filled by reference.
+    * @param headers response headers to be filled by reference.
+    * @param responseBody response body to be filled by reference.
+    * @param responseSource response body alternative source to be filled by reference (its resume handle is already
+    * provided, for generators deferring the response until data is available).
+    * @param responseDelayMs response delay in milliseconds to be filled by reference.
+    */
+    virtual void receiveSource(const std::uint64_t &receptionId,
+                               const nghttp2::asio_http2::server::request& req,
+                               const std::string &requestBody,
+                               const std::chrono::microseconds &receptionTimestampUs,
+                               unsigned int& statusCode,
+                               nghttp2::asio_http2::header_map& headers,
+                               std::string& responseBody,
+                               ResponseSource& responseSource,
+                               unsigned int &responseDelayMs) {
+        receive(receptionId, req, requestBody, receptionTimestampUs, statusCode, headers, responseBody, responseDelayMs);
+    }
 
     /**
     * Virtual error reception callback.
@@ -325,6 +812,10 @@ public:
     * If no description provided, empty json document ({}) is sent in the default implementation.
     * @param location location header content. Empty by default.
     * @param allowedMethods allowed methods vector given by server implementation. Empty by default.
+    *
+    * Note that SERVICE_UNAVAILABLE responses due to congestion control are not built through this
+    * method on every rejection: the default implementation response is prebuilt once at serve() and
+    * sent directly from the nghttp2 io thread, in order to keep load shedding as cheap as possible.
     */
     virtual void receiveError(const nghttp2::asio_http2::server::request& req,
                               const std::string &requestBody,
@@ -352,6 +843,26 @@ public:
     */
     virtual void streamClose(const std::uint64_t &receptionId) {;}
 
+    /**
+    * Lowest priority class of any executor, for requests without a valid priority (see priority())
+    */
+    static constexpr unsigned int LowestPriority = std::numeric_limits<unsigned int>::max();
+
+    /**
+    * Response delay value to hold the response until release() is called (see responseDelayMs())
+    */
+    static constexpr std::chrono::milliseconds HoldResponse = std::chrono::milliseconds::max();
+
+    /**
+    * Releases a held response (see responseDelayMs()), which is committed immediately.
+    * Held streams closed by the client are discarded.
+    *
+    * @param receptionId Unique recepcion identifier
+    *
+    * @return Boolean about held response found
+    */
+    bool release(const std::uint64_t &receptionId);
+
     /**
     * Virtual dynamic response delay in milliseconds
     *
@@ -360,9 +871,16 @@ public:
     * configured on receive(). A typical application could be setting a periodic check of a server
     * condition for a reception identifier to ensure some kind of synchronous scenario.
     *
+    * Instead of periodic checks, the response may be held returning HoldResponse, and then released
+    * by the application through release() as soon as the condition is fulfilled (no polling delay
+    * nor periodic wakeups). Note that this virtual is called again when the stream is held, to
+    * detect conditions fulfilled meanwhile, so it must stop returning HoldResponse before release()
+    * is called.
+    *
     * @param receptionId Unique recepcion identifier
     *
-    * @return milliseconds of delay, or zero() when no delay will be planned (default implementation).
+    * @return milliseconds of delay, HoldResponse to hold the response until release(), or zero() when
+    * no delay will be planned (default implementation).
     */
     virtual std::chrono::milliseconds responseDelayMs(const std::uint64_t &receptionId) {
         return std::chrono::milliseconds::zero();
@@ -398,7 +916,7 @@ public:
               const boost::posix_time::time_duration &readKeepAlive = boost::posix_time::seconds(60));
 
     /**
-    * Gets the timers io context used to manage response delays
+    * Gets the timers io context used to manage response delays (the first one when there is a pool)
     */
     boost::asio::io_context *getTimersIoContext() const {
         return timers_io_context_;
@@ -0,0 +1,165 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * Cache of metric handles indexed by method and code (status code or error code).
+ *
+ * Prometheus families resolve their instances through Family::Add(), which builds and hashes
+ * a labels map on every call. This cache resolves the handles once through the provided factory
+ * (so instances are created exactly when they were created before), and then hot paths only find
+ * them by method (small linear set) and code (direct index), without locks nor allocations.
+ *
+ * Codes out of range or methods beyond the maximum supported are resolved through an internal
+ * map protected by mutex, so they are still valid although slower.
+ */
+template <typename Handles>
+class MetricsCache
+{
+public:
+    using factory_t = std::function<Handles(const std::string &method, unsigned int code)>;
+
+private:
+    static constexpr std::size_t MaxMethods = 16;
+    static constexpr unsigned int MaxCodes = 600;
+
+    struct Entry {
+        std::string method;
+        std::array<std::atomic<const Handles*>, MaxCodes> codes{};
+
+        explicit Entry(const std::string &m) : method(m) {}
+    };
+
+    factory_t factory_;
+    std::array<std::atomic<Entry*>, MaxMethods> entries_{};
+
+    // Slow path (creations and overflow):
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Entry>> entries_storage_{};
+    std::deque<Handles> handles_storage_{}; // stable addresses
+    std::map<std::pair<std::string, unsigned int>, const Handles*> overflow_{};
+
+    const Handles &resolve(const std::string &method, unsigned int code) {
+        std::lock_guard<std::mutex> guard(mutex_);
+
+        Entry *entry = nullptr;
+        std::size_t k = 0;
+        for (; k < MaxMethods; k++) {
+            entry = entries_[k].load(std::memory_order_acquire);
+            if (!entry || entry->method == method) break;
+        }
+
+        if (code < MaxCodes && k < MaxMethods) {
+            if (!entry) {
+                entries_storage_.push_back(std::make_unique<Entry>(method));
+                entry = entries_storage_.back().get();
+                entries_[k].store(entry, std::memory_order_release);
+            }
+
+            const Handles *handles = entry->codes[code].load(std::memory_order_acquire);
+            if (!handles) {
+                handles_storage_.push_back(factory_(method, code));
+                handles = &handles_storage_.back();
+                entry->codes[code].store(handles, std::memory_order_release);
+            }
+            return *handles;
+        }
+
+        auto key = std::make_pair(method, code);
+        auto it = overflow_.find(key);
+        if (it == overflow_.end()) {
+            handles_storage_.push_back(factory_(method, code));
+            it = overflow_.emplace(std::move(key), &handles_storage_.back()).first;
+        }
+        return *(it->second);
+    }
+
+public:
+    /**
+    * Class constructor
+    *
+    * @param factory Function to resolve the handles (Family::Add() calls) for a given method and code
+    */
+    explicit MetricsCache(factory_t factory) : factory_(std::move(factory)) {}
+
+    MetricsCache(const MetricsCache&) = delete;
+    MetricsCache& operator=(const MetricsCache&) = delete;
+
+    /**
+    * Gets the handles for method and code, resolving them on first use
+    *
+    * @param method Request method
+    * @param code Status code or error code. Defaults to zero (handles only indexed by method).
+    *
+    * @return Handles reference, valid along the cache life
+    */
+    const Handles &get(const std::string &method, unsigned int code = 0) {
+        for (std::size_t k = 0; k < MaxMethods; k++) {
+            const Entry *entry = entries_[k].load(std::memory_order_acquire);
+            if (!entry) break;
+            if (entry->method == method) {
+                if (code >= MaxCodes) break;
+                const Handles *handles = entry->codes[code].load(std::memory_order_acquire);
+                if (handles) return *handles;
+                break;
+            }
+        }
+
+        return resolve(method, code);
+    }
+};
+
+}
+}
@@ -0,0 +1,91 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * 1-in-N sampling policy for distribution metrics (histograms and gauges).
+ *
+ * Counters must be exact, but delay and size distributions keep their shape when only a random
+ * subset of the transactions is observed, which saves most of the metrics CPU under high load
+ * (time measurements included). Decisions use a per-thread xorshift generator, so there is no
+ * shared state between threads nor correlation between consecutive decisions.
+ */
+class MetricsSampler
+{
+    unsigned int rate_;
+
+public:
+    /**
+    * Class constructor
+    *
+    * @param rate Sampling rate: one of every 'rate' transactions is observed. Zero or one means no sampling.
+    */
+    explicit MetricsSampler(unsigned int rate = 1) : rate_(rate > 1 ? rate : 1) {}
+
+    /**
+    * Decides if current transaction must be observed
+    */
+    bool sample() const {
+        if (rate_ == 1) return true;
+
+        thread_local std::uint64_t state = reinterpret_cast<std::uintptr_t>(&state) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return (state % rate_) == 0;
+    }
+
+    /**
+    * Gets the sampling rate
+    */
+    unsigned int getRate() const {
+        return rate_;
+    }
+};
+
+}
+}
@@ -0,0 +1,117 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ert/http2comm/Executor.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * Priority executor: streams are queued by priority class (zero is the highest one), and workers
+ * always take the highest priority stream available (strict priority), so signalling requests do
+ * not wait behind a backlog of bulk traffic.
+ *
+ * Starvation protection: every time a stream is taken while a lower priority class has streams
+ * waiting, that class is accounted as skipped. When a class is skipped 'starvationLimit' times in a
+ * row, its oldest stream is taken next, so every class gets at least one of 'starvationLimit + 1'
+ * processing slots under sustained higher priority load.
+ *
+ * Active threads may be limited (see setActiveThreads()): workers over the limit are parked once
+ * they finish their current stream. With a single priority class, this is a plain FIFO executor
+ * which can be autoscaled (see Autoscaler).
+ */
+class PriorityExecutor : public Executor
+{
+    std::vector<std::deque<std::shared_ptr<ert::queuedispatcher::StreamIf>>> queues_; // one per class
+    std::vector<unsigned int> skipped_; // consecutive skips per class
+    std::unique_ptr<std::atomic<int>[]> sizes_; // per class (lock free getters)
+    const unsigned int starvation_limit_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_; // active workers waiting for streams
+    std::condition_variable parked_cv_; // workers over active threads
+    std::vector<std::thread> threads_{};
+
+    std::atomic<int> size_{};
+    std::atomic<int> busy_{};
+    std::atomic<int> active_{}; // modified with mutex locked
+    bool stopped_{}; // protected by mutex
+
+    bool take(std::shared_ptr<ert::queuedispatcher::StreamIf> &stream); // with mutex locked
+    void run(int index);
+
+public:
+    /**
+    * Class constructor
+    *
+    * @param threads Number of worker threads
+    * @param priorities Number of priority classes. Defaults to 3
+    * @param starvationLimit Consecutive skips for a waiting class before it is served. Defaults to 16
+    */
+    explicit PriorityExecutor(std::size_t threads, unsigned int priorities = 3, unsigned int starvationLimit = 16);
+
+    /**
+    * Class destructor: workers are stopped, and pending streams are discarded
+    */
+    ~PriorityExecutor();
+
+    void dispatch(std::shared_ptr<ert::queuedispatcher::StreamIf> stream) override; // lowest priority class
+    void dispatch(std::shared_ptr<ert::queuedispatcher::StreamIf> stream, unsigned int priority) override;
+    unsigned int getPriorities() const override;
+    int getBusyThreads() const override;
+    int getThreads() const override; // active ones
+    bool setActiveThreads(std::size_t threads) override;
+    int getSize() const override;
+    int getSizeAhead(unsigned int priority) const override;
+};
+
+}
+}
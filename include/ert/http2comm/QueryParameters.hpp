@@ -0,0 +1,137 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * Query parameters parser which provides a canonical representation: parameters are percent-decoded,
+ * sorted (by key, and then by value) and deduplicated (identical key/value pairs appear once, but
+ * different values for the same key are kept). Equivalent queries, like 'b=2&a=1' and 'a=%31&b=2&a=1',
+ * have the same canonical representation, which is useful to key provisions by normalized URIs.
+ *
+ * Canonical representations are kept in a small LRU cache keyed by the raw query string, so repeated
+ * queries (typical from load generators) skip parsing entirely. The cache is thread-safe.
+ */
+class QueryParameters
+{
+public:
+
+    /**
+    * Canonical representation
+    */
+    struct Canonical {
+        std::vector<std::pair<std::string, std::string>> parameters; // decoded, sorted and deduplicated
+        std::string query; // parameters percent-encoded again and joined: 'k1=v1&k2=v2' ('k' for empty values)
+    };
+
+private:
+    struct Entry {
+        std::size_t hash;
+        std::string raw_query;
+        std::shared_ptr<const Canonical> canonical;
+    };
+
+    const std::size_t cache_size_;
+    const char separator_;
+
+    std::mutex mutex_;
+    std::list<Entry> lru_{}; // most recently used first
+    std::unordered_map<std::size_t, std::list<Entry>::iterator> index_{}; // by raw query hash
+    std::atomic<std::uint64_t> hits_{};
+    std::atomic<std::uint64_t> misses_{};
+
+public:
+
+    /**
+    * Class constructor
+    *
+    * @param cacheSize LRU cache maximum number of entries. Defaults to 1024 (zero disables cache)
+    * @param separator Query parameters separator. Defaults to '&'
+    */
+    explicit QueryParameters(std::size_t cacheSize = 1024, char separator = '&');
+
+    /**
+    * Gets the canonical representation of the raw query (cached)
+    *
+    * @param rawQuery Query string (without '?'), for example the nghttp2 request 'uri().raw_query'
+    *
+    * @return Shared canonical representation (valid even after its eviction from cache)
+    */
+    std::shared_ptr<const Canonical> canonical(std::string_view rawQuery);
+
+    /**
+    * Parses the raw query into its canonical representation (not cached)
+    *
+    * @param rawQuery Query string (without '?')
+    * @param canonical Canonical representation filled by reference
+    * @param separator Query parameters separator. Defaults to '&'
+    */
+    static void parse(std::string_view rawQuery, Canonical &canonical, char separator = '&');
+
+    /**
+    * Gets the number of cache hits
+    */
+    std::uint64_t getHits() const {
+        return hits_.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * Gets the number of cache misses
+    */
+    std::uint64_t getMisses() const {
+        return misses_.load(std::memory_order_relaxed);
+    }
+};
+
+}
+}
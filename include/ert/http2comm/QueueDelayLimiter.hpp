@@ -0,0 +1,137 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * CoDel-style (Controlled Delay) load shedder for queued streams.
+ *
+ * Queueing delay (sojourn time) is measured for every stream between its dispatch (nghttp2 io
+ * thread) and its processing (worker thread). When the minimum sojourn observed along a whole
+ * interval stays over the target, there is a standing queue (not a transient burst) and the
+ * limiter becomes overloaded: streams waiting longer than the target are dropped. Otherwise,
+ * only streams waiting longer than the interval are dropped.
+ *
+ * This is the CoDel adaptation to request queues, which sheds load based on the delay actually
+ * suffered by the requests instead of a queue size threshold tuned for a given host and traffic.
+ * All the methods are lock-free and may be called concurrently from any worker thread.
+ */
+class QueueDelayLimiter
+{
+    const std::int64_t target_us_;
+    const std::int64_t interval_us_;
+
+    std::atomic<std::int64_t> interval_end_us_{};
+    std::atomic<std::int64_t> min_delay_us_;
+    std::atomic<bool> overloaded_{};
+    std::atomic<std::uint64_t> dropped_{};
+
+    // Completes the current interval when elapsed (only one thread wins the evaluation):
+    void evaluate(std::int64_t nowUs);
+
+public:
+    /**
+    * Class constructor
+    *
+    * @param target acceptable standing queue delay.
+    * @param interval period used to detect a standing queue. It should be long enough to absorb
+    * traffic bursts (CoDel recommends 20 times the target, i.e.: 5 ms target, 100 ms interval).
+    */
+    QueueDelayLimiter(const std::chrono::microseconds &target, const std::chrono::microseconds &interval);
+
+    /**
+    * Registers the queueing delay of a stream and decides if it must be dropped
+    *
+    * @param sojourn time spent by the stream in the queue
+    *
+    * @return Boolean about dropping the stream
+    */
+    bool drop(const std::chrono::microseconds &sojourn);
+
+    /**
+    * Completes the current interval when elapsed without streams (to be called periodically), so
+    * the overload status ends when traffic stops instead of lasting until the next stream.
+    */
+    void refresh();
+
+    /**
+    * Gets the current sojourn limit: target when overloaded, interval otherwise
+    */
+    std::chrono::microseconds getLimit() const;
+
+    /**
+    * Gets the overload status (standing queue delay over target along the last interval)
+    */
+    bool isOverloaded() const {
+        return overloaded_.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * Gets the number of dropped streams
+    */
+    std::uint64_t getDropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * Gets the target delay
+    */
+    std::chrono::microseconds getTarget() const {
+        return std::chrono::microseconds(target_us_);
+    }
+
+    /**
+    * Gets the interval
+    */
+    std::chrono::microseconds getInterval() const {
+        return std::chrono::microseconds(interval_us_);
+    }
+};
+
+}
+}
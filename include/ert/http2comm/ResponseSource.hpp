@@ -0,0 +1,129 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <nghttp2/asio_http2.h>
+
+namespace ert
+{
+namespace http2comm
+{
+class Stream;
+
+/**
+ * Handle to resume a deferred response generator (see ResponseSource). It may be copied and called
+ * from any thread: resumption is posted to the stream nghttp2 io thread, and it is ignored once the
+ * stream is closed (the handle does not keep the stream alive).
+ */
+class ResumeHandle
+{
+    std::weak_ptr<Stream> stream_{};
+
+public:
+    ResumeHandle() = default;
+    explicit ResumeHandle(std::weak_ptr<Stream> stream) : stream_(std::move(stream)) {}
+
+    /**
+    * Resumes the generator, which will be pulled again from the nghttp2 io thread
+    */
+    void operator()() const;
+};
+
+/**
+ * Alternative sources for the response, which could be provided by the server application on
+ * reception (Http2Server::receiveSource()) instead of the materialized response body string and
+ * headers map filled by reference.
+ *
+ * Generator is the nghttp2 data provider: it is pulled from the nghttp2 io thread as the HTTP/2
+ * flow-control window opens, copying up to 'len' bytes into 'buf' and returning the amount of
+ * bytes copied. When the body is completed, NGHTTP2_DATA_FLAG_EOF must be set in 'data_flags'.
+ * Large or incrementally generated payloads are served this way with flat memory and lower
+ * time to first byte. As the generator runs on the nghttp2 io thread, it must not block: when no
+ * data is ready yet, it returns NGHTTP2_ERR_DEFERRED, and the producer calls the resume handle
+ * (provided by the library before reception callbacks) once more data is available. The generator
+ * is destroyed when the stream is closed.
+ *
+ * Body and headers are shared immutable buffers, typically prebuilt once by the application for
+ * static responses returned at high rates: the same bytes are sent for every request without
+ * per-request copies of the body into the stream. Shared headers are used instead of the headers
+ * map filled by reference.
+ *
+ * When both generator and body are provided, the generator is used.
+ */
+struct ResponseSource
+{
+    nghttp2::asio_http2::generator_cb generator{};
+    std::shared_ptr<const std::string> body{};
+    std::shared_ptr<const nghttp2::asio_http2::header_map> headers{};
+    ResumeHandle resume{}; // provided by the library, to be kept by deferring generators producers
+
+    /**
+    * Returns true when no alternative body source is provided (response body string is used)
+    */
+    bool empty() const {
+        return !generator && !body;
+    }
+
+    /**
+    * Releases provided sources
+    */
+    void clear() {
+        generator = nullptr;
+        body.reset();
+        headers.reset();
+        resume = ResumeHandle();
+    }
+
+    /**
+    * Builds a generator which sends a shared immutable body (the buffer is kept alive by the
+    * generator, which copies directly from it into nghttp2 frames).
+    *
+    * @param body Shared body
+    *
+    * @return nghttp2 generator callback
+    */
+    static nghttp2::asio_http2::generator_cb bodyGenerator(std::shared_ptr<const std::string> body);
+};
+
+}
+}
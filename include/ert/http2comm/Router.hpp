@@ -0,0 +1,191 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <memory>
+#include <chrono>
+#include <functional>
+
+#include <nghttp2/asio_http2_server.h>
+
+#include <ert/http2comm/ResponseSource.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * Radix tree router which maps request method and path into handlers in one pass.
+ *
+ * Route patterns are paths whose segments could be parameters given by their name between braces,
+ * for example '/users/{id}/orders'. Static segments have precedence over parameters. Matching does
+ * not allocate memory: parameters are views over the pattern names and the request path, and the
+ * cost depends on the path length but not on the number of routes registered.
+ *
+ * Routes must be added before the server is started (lookups are not protected against updates).
+ */
+class Router
+{
+public:
+
+    /**
+    * Maximum number of parameters within a route pattern
+    */
+    static constexpr std::size_t MaxParameters = 16;
+
+    /**
+    * Path parameters matched (views valid along the request processing)
+    */
+    class Parameters
+    {
+        std::array<std::pair<std::string_view, std::string_view>, MaxParameters> parameters_{};
+        std::size_t size_{};
+
+    public:
+        void push(std::string_view name, std::string_view value) {
+            parameters_[size_++] = std::make_pair(name, value);
+        }
+
+        void pop() {
+            size_--;
+        }
+
+        /**
+        * Gets parameters number
+        */
+        std::size_t size() const {
+            return size_;
+        }
+
+        /**
+        * Gets parameter (name and value) by position
+        */
+        const std::pair<std::string_view, std::string_view> &operator[](std::size_t pos) const {
+            return parameters_[pos];
+        }
+
+        /**
+        * Gets parameter value by name (empty when missing). Values are not percent-decoded.
+        */
+        std::string_view get(std::string_view name) const;
+    };
+
+    /**
+    * Route handler, with the same parameters than Http2Server::receiveSource() plus the path parameters
+    */
+    typedef std::function<void(const std::uint64_t &receptionId,
+                               const nghttp2::asio_http2::server::request& req,
+                               const std::string &requestBody,
+                               const Parameters &parameters,
+                               const std::chrono::microseconds &receptionTimestampUs,
+                               unsigned int& statusCode,
+                               nghttp2::asio_http2::header_map& headers,
+                               std::string& responseBody,
+                               ResponseSource& responseSource,
+                               unsigned int &responseDelayMs)> handler_t;
+
+    /**
+    * Lookup result: MethodNotAllowed when the path matches but not the method (even unknown methods),
+    * and MethodNotImplemented for unknown methods when the path does not match
+    */
+    enum Result { Found, NotFound, MethodNotAllowed, MethodNotImplemented };
+
+    /**
+    * Lookup match
+    */
+    struct Match {
+        const handler_t *handler{}; // when Found
+        const std::vector<std::string> *allowed_methods{}; // when Found or MethodNotAllowed
+        Parameters parameters{}; // when Found or MethodNotAllowed
+    };
+
+    Router();
+    ~Router();
+
+    /**
+    * Adds a route
+    *
+    * @param method Request method (GET, HEAD, POST, PUT, DELETE, CONNECT, OPTIONS, TRACE or PATCH)
+    * @param pattern Route pattern (starting with '/', with parameters as whole segments: '/users/{id}')
+    * @param handler Route handler
+    *
+    * @return Boolean about success: false for unknown methods, invalid patterns, or parameter names conflicting
+    * with an already registered route at the same position (the existing route handler is replaced otherwise)
+    */
+    bool add(const std::string &method, const std::string &pattern, handler_t handler);
+
+    /**
+    * Returns true when no route has been added
+    */
+    bool empty() const {
+        return empty_;
+    }
+
+    /**
+    * Route lookup
+    *
+    * @param method Request method
+    * @param path Request path (empty path is considered as '/')
+    * @param match Match filled by reference
+    *
+    * @return Lookup result
+    */
+    Result find(std::string_view method, std::string_view path, Match &match) const;
+
+    /**
+    * Gets the method index (known methods), or -1 for unknown ones
+    */
+    static int methodIndex(std::string_view method);
+
+private:
+    struct Node;
+    std::unique_ptr<Node> root_;
+    bool empty_{true};
+
+    const Node *find(const Node *node, std::string_view path, Parameters &parameters) const;
+};
+
+}
+}
@@ -0,0 +1,148 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <ert/metrics/Metrics.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * Thread-local sharded accumulation for counters and histograms.
+ *
+ * Every thread updating metrics (nghttp2 io threads, queue dispatcher workers) accumulates its
+ * counter increments and histogram observations into its own shard, so the shared prometheus
+ * instances are not written from several cores on every request. Shards are merged into those
+ * instances (Counter::Increment(value), Histogram::ObserveMultiple()) by a background thread
+ * along the configured merge period, so scraped families, instances and buckets are the same
+ * than with direct updates, just delayed up to one merge period (keep it shorter than the
+ * scrape interval).
+ *
+ * Gauges are not sharded: they keep the last value set, which is a single store.
+ *
+ * A zero merge period disables sharding: updates are done directly on the prometheus instances.
+ */
+class ShardedMetrics
+{
+    struct PendingHistogram {
+        const ert::metrics::bucket_boundaries_t *boundaries{};
+        std::vector<double> buckets{};
+        double sum{};
+        std::uint64_t count{};
+    };
+
+    struct Shard {
+        std::mutex mutex; // only contended on merge
+        std::unordered_map<ert::metrics::counter_t*, double> counters{};
+        std::unordered_map<ert::metrics::histogram_t*, PendingHistogram> histograms{};
+    };
+
+    const std::uint64_t id_;
+    const std::chrono::milliseconds merge_period_;
+
+    std::mutex shards_mutex_;
+    std::vector<std::shared_ptr<Shard>> shards_{};
+
+    std::mutex merger_mutex_;
+    std::condition_variable merger_cv_;
+    bool stop_{};
+    std::thread merger_{};
+
+    Shard &localShard();
+
+public:
+    /**
+    * Class constructor
+    *
+    * @param mergePeriod Period to merge the shards into prometheus instances. Zero disables sharding.
+    */
+    explicit ShardedMetrics(const std::chrono::milliseconds &mergePeriod);
+
+    ShardedMetrics(const ShardedMetrics&) = delete;
+    ShardedMetrics& operator=(const ShardedMetrics&) = delete;
+
+    /**
+    * Class destructor: stops the merger and merges the pending updates
+    */
+    ~ShardedMetrics();
+
+    /**
+    * Increments a counter
+    *
+    * @param counter Prometheus counter instance
+    * @param value Increment value. Defaults to 1.
+    */
+    void increment(ert::metrics::counter_t *counter, double value = 1.0);
+
+    /**
+    * Observes a histogram value
+    *
+    * @param histogram Prometheus histogram instance
+    * @param boundaries Bucket boundaries used to create the histogram instance
+    * @param value Observed value
+    */
+    void observe(ert::metrics::histogram_t *histogram, const ert::metrics::bucket_boundaries_t &boundaries, double value);
+
+    /**
+    * Merges all the shards into prometheus instances
+    */
+    void merge();
+
+    /**
+    * Gets the merge period (zero when sharding is disabled)
+    */
+    const std::chrono::milliseconds &getMergePeriod() const {
+        return merge_period_;
+    }
+};
+
+}
+}
@@ -45,6 +45,8 @@ SOFTWARE.
 #include <chrono>
 
 #include <ert/queuedispatcher/StreamIf.hpp>
+#include <ert/http2comm/ResponseSource.hpp>
+#include <ert/http2comm/TimingWheel.hpp>
 
 #include <boost/asio.hpp>
 
@@ -56,6 +58,8 @@ namespace ert
 namespace http2comm
 {
 class Http2Server;
+class QueueDelayLimiter;
+class Autoscaler;
 
 /**
  * This class allows the response of an http2 transaction to be run in a
@@ -75,13 +79,13 @@ class Http2Server;
  *
  * @see https://gist.github.com/tatsuhiro-t/ba3f7d72d037027ae47b
  */
-class Stream : public ert::queuedispatcher::StreamIf
-//class Stream : public std::enable_shared_from_this<Stream>
+class Stream : public ert::queuedispatcher::StreamIf, public std::enable_shared_from_this<Stream>
 {
     std::mutex mutex_;
-    const nghttp2::asio_http2::server::request& req_;
-    const nghttp2::asio_http2::server::response& res_;
+    const nghttp2::asio_http2::server::request *req_;  // pointers to allow reuse (StreamPool)
+    const nghttp2::asio_http2::server::response *res_;
     std::string request_body_;
+    std::size_t streamed_body_size_{}; // request body not accumulated (streaming reception)
     Http2Server *server_;
     bool closed_;
     bool error_; // error detected on stream transport
@@ -90,12 +94,30 @@ class Stream : public ert::queuedispatcher::StreamIf
     unsigned int status_code_{}; // not very smart, but we also use this to transport RST_STREAM & GOAWAY error codes, up to '0xd' < HTTP2 Status Codes Base (100)
     nghttp2::asio_http2::header_map response_headers_{};
     std::string response_body_{};
-    std::shared_ptr<boost::asio::steady_timer> timer_{};
+    ResponseSource response_source_{}; // alternative to response body
+    std::size_t response_body_size_{}; // for metrics
+    TimingWheel::Timer timer_; // response delays
+    std::chrono::milliseconds timer_delay_{};
     bool need_timer_{};
+    bool timer_scheduled_{}; // along the transaction, protected by mutex (cancelled on close only when scheduled)
+    bool need_hold_{}; // held until Http2Server::release()
+    bool held_{}; // indexed by Http2Server::hold(), protected by mutex (unheld on close)
+    void timerExpired();
+
+    // Request body reservation (first chunk): content-length or size class
+    void reserveRequestBody();
+
+    // Reception resolved by server router
+    void route(unsigned int &responseDelayMs);
 
     // For metrics:
     std::chrono::microseconds reception_timestamp_us_{}; // timestamp in microseconds
 
+    // For queue delay:
+    std::chrono::steady_clock::time_point dispatch_timestamp_{};
+    QueueDelayLimiter *queue_delay_limiter_{}; // executor one (default or bulkhead)
+    Autoscaler *autoscaler_{}; // default executor one
+
     // Server sequence id passed to this stream:
     std::uint64_t reception_id_{};
 
@@ -108,9 +130,16 @@ public:
     //~Stream() = default;
     //Stream& operator=(const Stream&) = delete;
 
+    // Binds the stream to a new transaction, keeping reserved capacity (StreamPool)
+    void reuse(const nghttp2::asio_http2::server::request& req,
+               const nghttp2::asio_http2::server::response& res);
+
+    // Releases transaction resources before returning the stream to the pool (StreamPool)
+    void recycle();
+
     // nghttp2-asio request structure
     const nghttp2::asio_http2::server::request& getReq() const {
-        return req_;
+        return *req_;
     }
 
     void setReceptionId(const std::uint64_t &id) {
@@ -121,9 +150,20 @@ public:
         return reception_id_;
     }
 
+    void setDispatchTimestamp(const std::chrono::steady_clock::time_point &timestamp, QueueDelayLimiter *queueDelayLimiter, Autoscaler *autoscaler) {
+        dispatch_timestamp_ = timestamp;
+        queue_delay_limiter_ = queueDelayLimiter;
+        autoscaler_ = autoscaler;
+    }
+
     // append received data chunk
     void appendData(const uint8_t* data, std::size_t len);
 
+    // account data chunk delivered to the application (streaming reception)
+    void addStreamedDataLen(std::size_t len) {
+        streamed_body_size_ += len;
+    }
+
     // Used by queue dispatcher:
     void process(bool busyConsumers, int queueSize);
 
@@ -131,14 +171,29 @@ public:
     void reception(bool congestion = false);
 
     // Completes the nghttp2 transaction (res.end()) with the values calculated at process()
+    // (the io thread handler owns the stream, so it can not be recycled meanwhile, see StreamPool)
     void commit();
 
-    void updateMetrics(const char *resultCodeLabel);
+    // Resumes a deferred response generator (posted to the nghttp2 io thread, see ResumeHandle)
+    void resume();
+
+    // Answers the server prebuilt congestion response (must be called from nghttp2 io thread)
+    void reject();
+
+    // Answers a prebuilt response bypassing reception() (must be called from nghttp2 io thread)
+    void respond(unsigned int statusCode, const nghttp2::asio_http2::header_map &headers, const std::shared_ptr<const std::string> &body);
+
+    // Metrics labeled by status code, or by RST_STREAM/GOAWAY error code on transport errors
+    void updateMetrics(bool transportError);
 
     void close();
 
     void error(uint32_t error_code);
 
+    // Stream closed by the client, or transport error
+    bool isClosed();
+
+    // Cancels response delays (timer or hold) on stream close
     void cancelTimer();
 };
 
@@ -0,0 +1,147 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <nghttp2/asio_http2_server.h>
+
+namespace ert
+{
+namespace http2comm
+{
+class Http2Server;
+class Stream;
+
+/**
+ * Pool of Stream objects, intended to be used from a single nghttp2 io thread.
+ *
+ * Streams are recycled when the last shared pointer reference is dropped (after res.on_close()
+ * and queue dispatcher processing), keeping the already reserved capacity for request and
+ * response bodies. Shared pointer control blocks are also recycled through the pool allocator,
+ * so a steady state reception does not allocate any Stream related memory.
+ *
+ * Release may happen from any thread (worker threads hold streams too), so the pool is mutex
+ * protected, although normally uncontended.
+ *
+ * As a released stream is reused for another transaction, asynchronous handlers bound to a stream
+ * must capture its owning shared pointer, never the raw pointer: otherwise a handler queued when the
+ * client closes the stream could run after reuse, answering the new request with the old response.
+ *
+ * The pool must outlive the streams acquired from it (they are returned to the pool on release).
+ * Control blocks do not own the pool: idle streams keep their last control block alive (through
+ * std::enable_shared_from_this weak reference), so that would be a reference cycle.
+ */
+class StreamPool
+{
+    Http2Server *server_;
+    const std::size_t max_size_;
+
+    std::mutex mutex_;
+    std::vector<Stream*> streams_{};
+    std::vector<void*> blocks_{}; // control blocks
+    std::size_t block_size_{};
+
+    template <typename T>
+    struct Allocator
+    {
+        using value_type = T;
+        StreamPool *pool; // outlives the control blocks (see class description)
+
+        explicit Allocator(StreamPool *p) : pool(p) {}
+        template <typename U>
+        Allocator(const Allocator<U> &other) : pool(other.pool) {}
+
+        T *allocate(std::size_t n) {
+            return static_cast<T*>(pool->allocateBlock(n * sizeof(T)));
+        }
+        void deallocate(T *p, std::size_t n) {
+            pool->deallocateBlock(p, n * sizeof(T));
+        }
+        template <typename U>
+        bool operator==(const Allocator<U> &other) const {
+            return pool == other.pool;
+        }
+        template <typename U>
+        bool operator!=(const Allocator<U> &other) const {
+            return pool != other.pool;
+        }
+    };
+
+    void *allocateBlock(std::size_t size);
+    void deallocateBlock(void *block, std::size_t size);
+    void release(Stream *stream);
+
+public:
+    /**
+    * Class constructor
+    *
+    * @param server Server owning the streams
+    * @param maxSize Maximum number of idle streams kept in the pool
+    */
+    StreamPool(Http2Server *server, std::size_t maxSize);
+    ~StreamPool();
+
+    StreamPool(const StreamPool&) = delete;
+    StreamPool& operator=(const StreamPool&) = delete;
+
+    /**
+    * Gets a stream bound to the nghttp2 transaction
+    *
+    * @param req nghttp2-asio request structure
+    * @param res nghttp2-asio response structure
+    * @param hit Filled by reference: true when the stream was recycled from the pool
+    *
+    * @return Stream shared pointer, which returns the stream to the pool when released
+    */
+    std::shared_ptr<Stream> acquire(const nghttp2::asio_http2::server::request& req,
+                                    const nghttp2::asio_http2::server::response& res,
+                                    bool &hit);
+
+    /**
+    * Gets the number of idle streams in the pool
+    */
+    std::size_t size();
+};
+
+}
+}
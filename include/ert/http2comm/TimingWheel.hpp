@@ -0,0 +1,176 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include <boost/asio.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * Hierarchical timing wheel (1 millisecond ticks) used to schedule server response delays.
+ *
+ * There is a first level of 256 slots (one per tick), and three levels of 64 slots whose entries
+ * are cascaded into the lower level when it completes a turn (so, delays up to 2^26 ms, about 18
+ * hours, are managed without overflow, and longer delays are cascaded until expiration). Timers
+ * are intrusive list entries, so scheduling and cancellation are O(1) without allocations, and the
+ * expiration cost is proportional to the ticks elapsed and the timers expired, not to the number
+ * of timers pending (as happens with asio timers heap).
+ *
+ * The wheel is driven by a steady timer on the provided io context, which only ticks while there
+ * are timers pending. Expiration callbacks are executed from that io context thread, out of the
+ * wheel lock, so they may schedule again their own timer. The wheel may be destroyed while its io
+ * context keeps running (destruction waits for a tick in progress, and handlers still queued in the
+ * io context are ignored afterwards), but not from its own expiration callbacks.
+ */
+class TimingWheel
+{
+    struct Link {
+        Link *prev{};
+        Link *next{};
+    };
+
+public:
+
+    /**
+    * Timer entry. It must outlive its scheduling (cancel it before destruction).
+    */
+    class Timer : private Link
+    {
+        friend class TimingWheel;
+        std::function<void()> callback_;
+        std::uint64_t expiry_{}; // tick
+        bool pending_{}; // in the wheel (not expired)
+
+    public:
+        /**
+        * Class constructor
+        *
+        * @param callback Expiration callback
+        */
+        explicit Timer(std::function<void()> callback) : callback_(std::move(callback)) {}
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+    };
+
+    /**
+    * Class constructor
+    *
+    * @param ioContext Io context where the wheel is driven (and expiration callbacks are executed)
+    */
+    explicit TimingWheel(boost::asio::io_context &ioContext);
+    ~TimingWheel();
+
+    /**
+    * Schedules the timer (re-scheduled if it was already pending)
+    *
+    * @param timer Timer entry
+    * @param delay Delay (rounded up to the tick)
+    */
+    void schedule(Timer &timer, const std::chrono::milliseconds &delay);
+
+    /**
+    * Cancels the timer. If its callback is being executed from another thread, this waits for its
+    * completion, so the timer entry may be safely destroyed or reused afterwards.
+    *
+    * @param timer Timer entry
+    *
+    * @return Boolean about timer pending before cancellation
+    */
+    bool cancel(Timer &timer);
+
+    /**
+    * Gets the number of timers pending
+    */
+    std::size_t size() const;
+
+private:
+    static constexpr int Level0Bits = 8;
+    static constexpr int LevelBits = 6;
+    static constexpr std::uint64_t Level0Size = 1 << Level0Bits;
+    static constexpr std::uint64_t LevelSize = 1 << LevelBits;
+    static constexpr std::uint64_t MaxDelta = (std::uint64_t(1) << (Level0Bits + 3 * LevelBits)) - 1;
+
+    // Io context handlers reach the wheel through this guard (nullptr once destroyed):
+    struct Guard {
+        std::mutex mutex; // held along ticks
+        TimingWheel *wheel;
+    };
+    std::shared_ptr<Guard> guard_;
+
+    boost::asio::steady_timer driver_;
+    const std::chrono::steady_clock::time_point origin_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable firing_cv_;
+    std::array<Link, Level0Size> level0_{};
+    std::array<std::array<Link, LevelSize>, 3> levels_{};
+    Link expired_{};
+    std::uint64_t current_{}; // next tick to process
+    std::size_t size_{};
+    bool running_{};
+    bool stopped_{};
+    Timer *firing_{};
+    std::thread::id firing_thread_{};
+
+    std::uint64_t now() const;
+    static void init(Link &list);
+    static void append(Link &list, Link *link);
+    static void unlink(Link *link);
+    void insert(Timer *timer);
+    void cascade(std::array<Link, LevelSize> &level, std::uint64_t index);
+    void arm();
+    void tick();
+};
+
+}
+}
@@ -40,6 +40,7 @@ SOFTWARE.
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace ert
 {
@@ -55,28 +56,91 @@ public:
      *
      * @param decodedUrl URL to be encoded.
      */
-    static std::string encode(const std::string& decodedUrl);
+    static std::string encode(std::string_view decodedUrl);
+
+    /**
+     * Percent-encoder for URL provided, appending the result into the output buffer
+     * (so, buffers may be reused to avoid allocations).
+     *
+     * @param decodedUrl URL to be encoded.
+     * @param encodedUrl Output buffer where encoded URL is appended.
+     */
+    static void encode(std::string_view decodedUrl, std::string &encodedUrl);
 
     /**
      * Percent-decoder for URL provided.
      *
      * @param encodedUrl URL to be decoded.
      */
-    static std::string decode(const std::string& encodedUrl);
+    static std::string decode(std::string_view encodedUrl);
+
+    /**
+     * Percent-decoder for URL provided, appending the result into the output buffer
+     * (so, buffers may be reused to avoid allocations).
+     *
+     * @param encodedUrl URL to be decoded.
+     * @param decodedUrl Output buffer where decoded URL is appended.
+     */
+    static void decode(std::string_view encodedUrl, std::string &decodedUrl);
+
+    /**
+     * Percent-decoder for URL provided, in place (decoded URL is never longer than the encoded one).
+     *
+     * @param url URL to be decoded.
+     */
+    static void decodeInPlace(std::string &url);
 
     /**
     * Normalize URL path and provided path prefix and then
-    * match the prefix within the URL.
+    * match the prefix within the URL. Normalization (slashes
+    * at both sides) is virtual, so no copies are done.
     *
     * @param urlPath URL path to analize
     * @param pathPrefix Path to be matched
     *
     * @return Boolean about if the prefix is matched with the URL path
     */
-    static bool matchPrefix(const std::string& urlPath,
-                            const std::string& pathPrefix);
+    static bool matchPrefix(std::string_view urlPath,
+                            std::string_view pathPrefix);
+};
+
+/**
+ * Query string tokenizer, which yields key/value views into the original query (for example
+ * the nghttp2 request 'uri().raw_query'), so no allocations are done. Empty tokens are skipped,
+ * and keys without '=' have empty values. Views are not percent-decoded: URLFunctions::decode()
+ * may be used for that.
+ *
+ * <pre>
+ *    QueryTokenizer tokenizer(req.uri().raw_query);
+ *    std::string_view key, value;
+ *    while (tokenizer.next(key, value)) { ... }
+ * </pre>
+ */
+class QueryTokenizer
+{
+    std::string_view query_;
+    std::size_t pos_{};
+    char separator_;
+
+public:
+    /**
+    * Class constructor
+    *
+    * @param query Query string (without '?'), which must outlive the tokenizer and the views provided
+    * @param separator Query parameters separator, '&' by default
+    */
+    explicit QueryTokenizer(std::string_view query, char separator = '&') : query_(query), separator_(separator) {}
+
+    /**
+    * Gets the next query parameter
+    *
+    * @param key Parameter key view filled by reference
+    * @param value Parameter value view filled by reference
+    *
+    * @return Boolean about parameter extracted (false when query is exhausted)
+    */
+    bool next(std::string_view &key, std::string_view &value);
 };
 
 }
 }
-
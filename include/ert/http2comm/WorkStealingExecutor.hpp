@@ -0,0 +1,128 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ert/http2comm/Executor.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+/**
+ * Work stealing executor: every worker thread owns a bounded lock-free queue (Vyukov MPMC ring),
+ * where nghttp2 io threads dispatch streams in round robin. Workers process their own queue and,
+ * when it is empty, steal from the other workers queues, so bursts are spread without a single
+ * contended queue. When every queue is full, streams go to a shared overflow queue (so, there is
+ * no limit as happens with the queue dispatcher). Idle workers are parked on a condition variable.
+ */
+class WorkStealingExecutor : public Executor
+{
+    class Queue
+    {
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            std::shared_ptr<ert::queuedispatcher::StreamIf> stream;
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        const std::size_t mask_;
+        alignas(64) std::atomic<std::size_t> enqueue_pos_{};
+        alignas(64) std::atomic<std::size_t> dequeue_pos_{};
+
+    public:
+        explicit Queue(std::size_t capacity); // rounded up to power of two
+        bool push(std::shared_ptr<ert::queuedispatcher::StreamIf> &stream); // moved when successful
+        bool pop(std::shared_ptr<ert::queuedispatcher::StreamIf> &stream);
+    };
+
+    struct Worker {
+        Queue queue;
+        std::thread thread{};
+        explicit Worker(std::size_t capacity) : queue(capacity) {}
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_{};
+
+    std::mutex overflow_mutex_;
+    std::deque<std::shared_ptr<ert::queuedispatcher::StreamIf>> overflow_{};
+    std::atomic<int> overflow_size_{};
+
+    std::mutex park_mutex_;
+    std::condition_variable park_cv_;
+    std::atomic<int> idle_{};
+
+    std::atomic<int> size_{};
+    std::atomic<int> busy_{};
+    std::atomic<bool> stopped_{};
+
+    bool take(std::size_t index, std::shared_ptr<ert::queuedispatcher::StreamIf> &stream);
+    void run(std::size_t index);
+
+public:
+    /**
+    * Class constructor
+    *
+    * @param threads Number of worker threads
+    * @param queueCapacity Capacity of every worker queue. Defaults to 1024
+    */
+    explicit WorkStealingExecutor(std::size_t threads, std::size_t queueCapacity = 1024);
+
+    /**
+    * Class destructor: workers are stopped, and pending streams are discarded
+    */
+    ~WorkStealingExecutor();
+
+    void dispatch(std::shared_ptr<ert::queuedispatcher::StreamIf> stream) override;
+    int getBusyThreads() const override;
+    int getThreads() const override;
+    int getSize() const override;
+};
+
+}
+}
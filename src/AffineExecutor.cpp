@@ -0,0 +1,172 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <unordered_map>
+
+#include <ert/http2comm/AffineExecutor.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+namespace
+{
+std::atomic<std::uint64_t> AffineExecutorIds{};
+}
+
+AffineExecutor::AffineExecutor(const std::string &name, std::size_t shards, std::size_t threadsPerShard, std::size_t maxThreadsPerShard, std::chrono::milliseconds samplingPeriod) :
+    id_(AffineExecutorIds.fetch_add(1) + 1), sampling_period_(samplingPeriod > std::chrono::milliseconds(0) ? samplingPeriod : std::chrono::milliseconds(1))
+{
+    if (shards == 0) shards = 1;
+
+    shards_.resize(shards);
+    for (std::size_t k = 0; k < shards; k++) {
+        shards_[k].queue_dispatcher = std::make_unique<ert::queuedispatcher::QueueDispatcher>(name + "_shard" + std::to_string(k), threadsPerShard, maxThreadsPerShard);
+    }
+}
+
+AffineExecutor::~AffineExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    cv_.notify_all();
+
+    if (sampler_.joinable()) sampler_.join();
+}
+
+std::size_t AffineExecutor::shardIndex()
+{
+    // Dispatching thread binding (last executor cached, as a thread normally dispatches to only one):
+    thread_local std::uint64_t executorId{};
+    thread_local std::size_t index{};
+    thread_local std::unordered_map<std::uint64_t, std::size_t> indexes{};
+
+    if (executorId == id_) return index;
+
+    auto it = indexes.find(id_);
+    if (it == indexes.end()) {
+        it = indexes.emplace(id_, next_shard_.fetch_add(1) % shards_.size()).first;
+    }
+
+    executorId = id_;
+    index = it->second;
+    return index;
+}
+
+void AffineExecutor::dispatch(std::shared_ptr<ert::queuedispatcher::StreamIf> stream)
+{
+    shards_[shardIndex()].queue_dispatcher->dispatch(std::move(stream));
+}
+
+void AffineExecutor::sample()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        bool stopped = cv_.wait_for(lock, sampling_period_, [this]() {
+            return stopped_;
+        });
+        if (stopped) return;
+
+        for (auto &shard : shards_) {
+            shard.size_gauge->Set(shard.queue_dispatcher->getSize());
+            shard.busy_threads_gauge->Set(shard.queue_dispatcher->getBusyThreads());
+        }
+    }
+}
+
+int AffineExecutor::getBusyThreads() const
+{
+    int result = 0;
+    for (const auto &shard : shards_) result += shard.queue_dispatcher->getBusyThreads();
+    return result;
+}
+
+int AffineExecutor::getThreads() const
+{
+    int result = 0;
+    for (const auto &shard : shards_) result += shard.queue_dispatcher->getThreads();
+    return result;
+}
+
+int AffineExecutor::getSize() const
+{
+    int result = 0;
+    for (const auto &shard : shards_) result += shard.queue_dispatcher->getSize();
+    return result;
+}
+
+bool AffineExecutor::congested(int queueMaxSize, unsigned int priority)
+{
+    const auto &queueDispatcher = shards_[shardIndex()].queue_dispatcher;
+    return (queueDispatcher->getBusyThreads() >= queueDispatcher->getThreads() && queueDispatcher->getSize() > queueMaxSize);
+}
+
+int AffineExecutor::getShardBusyThreads(std::size_t shard) const
+{
+    return shards_[shard].queue_dispatcher->getBusyThreads();
+}
+
+int AffineExecutor::getShardSize(std::size_t shard) const
+{
+    return shards_[shard].queue_dispatcher->getSize();
+}
+
+void AffineExecutor::enableMetrics(ert::metrics::Metrics *metrics, const std::string &name, const std::string &source)
+{
+    if (!metrics || metrics_) return;
+
+    ert::metrics::labels_t familyLabels = {};
+    auto &sizeGaugeFamily = metrics->addGaugeFamily(name + "_executor_shard_queue_size_gauge", "Executor shard queue size gauge in " + name, familyLabels);
+    auto &busyThreadsGaugeFamily = metrics->addGaugeFamily(name + "_executor_shard_busy_threads_gauge", "Executor shard busy threads gauge in " + name, familyLabels);
+
+    for (std::size_t k = 0; k < shards_.size(); k++) {
+        ert::metrics::labels_t labels = {{"source", source}, {"shard", std::to_string(k)}};
+        shards_[k].size_gauge = &(sizeGaugeFamily.Add(labels));
+        shards_[k].busy_threads_gauge = &(busyThreadsGaugeFamily.Add(labels));
+    }
+
+    metrics_.store(true, std::memory_order_release);
+    sampler_ = std::thread(&AffineExecutor::sample, this);
+}
+
+}
+}
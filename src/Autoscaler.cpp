@@ -0,0 +1,157 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+
+#include <ert/tracing/Logger.hpp>
+
+#include <ert/http2comm/Autoscaler.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+namespace
+{
+const unsigned int BusyRatioSamplesPerPeriod = 10;
+}
+
+Autoscaler::Autoscaler(Executor &executor, std::size_t minThreads, std::size_t maxThreads, const AutoscalerConfig &config) :
+    executor_(executor), min_threads_(minThreads > 0 ? minThreads : 1), max_threads_(maxThreads > min_threads_ ? maxThreads : min_threads_), config_(config), target_threads_(min_threads_)
+{
+    executor_.setActiveThreads(min_threads_);
+    thread_ = std::thread(&Autoscaler::run, this);
+}
+
+Autoscaler::~Autoscaler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    cv_.notify_all();
+
+    if (thread_.joinable()) thread_.join();
+}
+
+void Autoscaler::run()
+{
+    auto sampling = config_.period / BusyRatioSamplesPerPeriod;
+    if (sampling < std::chrono::milliseconds(1)) sampling = std::chrono::milliseconds(1);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        bool stopped = cv_.wait_for(lock, sampling, [this]() {
+            return stopped_;
+        });
+        if (stopped) return;
+
+        int threads = executor_.getThreads();
+        busy_ratio_sum_ += (threads > 0 ? (double)executor_.getBusyThreads() / threads : 0.0);
+
+        if (++busy_ratio_samples_ >= BusyRatioSamplesPerPeriod) {
+            evaluate();
+        }
+    }
+}
+
+void Autoscaler::evaluate()
+{
+    std::uint64_t count = queue_delay_count_.exchange(0, std::memory_order_relaxed);
+    std::uint64_t sum = queue_delay_sum_us_.exchange(0, std::memory_order_relaxed);
+    std::chrono::microseconds queueDelay(count > 0 ? sum / count : 0);
+    double busyRatio = busy_ratio_sum_ / busy_ratio_samples_;
+    busy_ratio_sum_ = 0;
+    busy_ratio_samples_ = 0;
+
+    std::size_t target = target_threads_.load(std::memory_order_relaxed);
+
+    if (queueDelay > config_.scale_up_queue_delay || busyRatio >= config_.scale_up_busy_ratio) {
+        calm_periods_ = 0;
+        if (target < max_threads_) {
+            scale(std::min(target + config_.step, max_threads_), true);
+        }
+    }
+    else if (queueDelay < config_.scale_down_queue_delay && busyRatio < config_.scale_down_busy_ratio) {
+        if (++calm_periods_ >= config_.scale_down_periods) {
+            calm_periods_ = 0;
+            if (target > min_threads_) {
+                scale((target - min_threads_ > config_.step) ? target - config_.step : min_threads_, false);
+            }
+        }
+    }
+    else {
+        calm_periods_ = 0;
+    }
+}
+
+void Autoscaler::scale(std::size_t threads, bool up)
+{
+    LOGINFORMATIONAL(
+        std::string msg = ert::tracing::Logger::asString("Autoscaling worker threads from %zu to %zu", target_threads_.load(), threads);
+        ert::tracing::Logger::informational(msg, ERT_FILE_LOCATION);
+    );
+
+    executor_.setActiveThreads(threads);
+    target_threads_.store(threads, std::memory_order_relaxed);
+
+    // metrics
+    if (metrics_.load(std::memory_order_acquire)) {
+        target_threads_gauge_ptr_->Set(threads);
+        (up ? scale_up_counter_ptr_ : scale_down_counter_ptr_)->Increment();
+    }
+}
+
+void Autoscaler::enableMetrics(ert::metrics::Metrics *metrics, const std::string &name, const std::string &source)
+{
+    if (!metrics || metrics_) return;
+
+    ert::metrics::labels_t familyLabels = {};
+    target_threads_gauge_ptr_ = &(metrics->addGaugeFamily(name + "_autoscaler_target_threads_gauge", "Autoscaler target worker threads gauge in " + name, familyLabels).Add({{"source", source}}));
+    auto &scalingEventsCounterFamily = metrics->addCounterFamily(name + "_autoscaler_scaling_events_counter", "Autoscaler scaling events counter in " + name, familyLabels);
+    scale_up_counter_ptr_ = &(scalingEventsCounterFamily.Add({{"source", source}, {"direction", "up"}}));
+    scale_down_counter_ptr_ = &(scalingEventsCounterFamily.Add({{"source", source}, {"direction", "down"}}));
+
+    target_threads_gauge_ptr_->Set(target_threads_.load());
+    metrics_.store(true, std::memory_order_release);
+}
+
+}
+}
@@ -0,0 +1,78 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <ert/http2comm/BodySizeEstimator.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+BodySizeEstimator::BodySizeEstimator(double percentile, double step) : percentile_(percentile), step_(step), estimate_(MinSizeClass)
+{
+}
+
+void BodySizeEstimator::observe(std::size_t size)
+{
+    double estimate = estimate_.load(std::memory_order_relaxed);
+
+    // Equilibrium when P(size > estimate) * percentile == P(size <= estimate) * (1 - percentile):
+    if (size > estimate) {
+        estimate *= (1 + step_ * percentile_);
+    }
+    else {
+        estimate *= (1 - step_ * (1 - percentile_));
+    }
+
+    if (estimate < MinSizeClass) estimate = MinSizeClass;
+    estimate_.store(estimate, std::memory_order_relaxed);
+}
+
+std::size_t BodySizeEstimator::getSizeClass() const
+{
+    double estimate = getEstimate();
+
+    std::size_t result = MinSizeClass;
+    while (result < estimate) result <<= 1;
+
+    return result;
+}
+
+}
+}
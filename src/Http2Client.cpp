@@ -97,7 +97,9 @@ std::string Http2Client::response::asString() {
 
 void Http2Client::enableMetrics(ert::metrics::Metrics *metrics,
                                 const ert::metrics::bucket_boundaries_t &responseDelaySecondsHistogramBucketBoundaries,
-                                const ert::metrics::bucket_boundaries_t &messageSizeBytesHistogramBucketBoundaries, const std::string &source) {
+                                const ert::metrics::bucket_boundaries_t &messageSizeBytesHistogramBucketBoundaries, const std::string &source,
+                                const std::chrono::milliseconds &shardedMetricsMergePeriod,
+                                unsigned int samplingRate) {
 
     metrics_ = metrics;
 
@@ -125,6 +127,33 @@ void Http2Client::enableMetrics(ert::metrics::Metrics *metrics,
 
         response_delay_seconds_histogram_bucket_boundaries_ = responseDelaySecondsHistogramBucketBoundaries;
         message_size_bytes_histogram_bucket_boundaries_ = messageSizeBytesHistogramBucketBoundaries;
+        sharded_metrics_ = std::make_unique<ShardedMetrics>(shardedMetricsMergePeriod);
+        metrics_sampler_ = MetricsSampler(samplingRate);
+
+        sent_messages_metrics_ = std::make_unique<MetricsCache<SentMessageMetrics>>([this](const std::string &method, unsigned int) {
+            ert::metrics::labels_t labels = {{"source", source_}, {"method", method}};
+            return SentMessageMetrics{
+                &(observed_requests_sents_counter_family_ptr_->Add(labels)),
+                &(sent_messages_size_bytes_gauge_family_ptr_->Add(labels)),
+                &(sent_messages_size_bytes_histogram_family_ptr_->Add(labels, message_size_bytes_histogram_bucket_boundaries_))
+            };
+        });
+        requests_unsents_counters_ = std::make_unique<MetricsCache<ert::metrics::counter_t*>>([this](const std::string &method, unsigned int) {
+            return &(observed_requests_unsents_counter_family_ptr_->Add({{"source", source_}, {"method", method}}));
+        });
+        responses_timedout_counters_ = std::make_unique<MetricsCache<ert::metrics::counter_t*>>([this](const std::string &method, unsigned int) {
+            return &(observed_responses_timedout_counter_family_ptr_->Add({{"source", source_}, {"method", method}}));
+        });
+        responses_metrics_ = std::make_unique<MetricsCache<ResponseMetrics>>([this](const std::string &method, unsigned int statusCode) {
+            ert::metrics::labels_t labels = {{"source", source_}, {"method", method}, {"status_code", std::to_string(statusCode)}};
+            return ResponseMetrics{
+                &(observed_responses_received_counter_family_ptr_->Add(labels)),
+                &(responses_delay_seconds_gauge_family_ptr_->Add(labels)),
+                &(responses_delay_seconds_histogram_family_ptr_->Add(labels, response_delay_seconds_histogram_bucket_boundaries_)),
+                &(received_messages_size_bytes_gauge_family_ptr_->Add(labels)),
+                &(received_messages_size_bytes_histogram_family_ptr_->Add(labels, message_size_bytes_histogram_bucket_boundaries_))
+            };
+        });
     }
 }
 
@@ -168,8 +197,7 @@ void Http2Client::async_send(
         {
             // metrics
             if (metrics_) {
-                auto& counter = observed_requests_unsents_counter_family_ptr_->Add({{"source", source_}, {"method", method}});
-                counter.Increment();
+                sharded_metrics_->increment(requests_unsents_counters_->get(method));
             }
 
             // Invoke callback
@@ -186,15 +214,16 @@ void Http2Client::async_send(
     const bool noBodyMethod = (method == "GET" || method == "DELETE" || method == "HEAD");
 
     // metrics
+    const bool sampled = (metrics_ && metrics_sampler_.sample()); // gauges & histograms for the whole transaction
     if (metrics_) {
-        auto& counter = observed_requests_sents_counter_family_ptr_->Add({{"source", source_}, {"method", method}});
-        counter.Increment();
-
-        std::size_t requestBodySize = (noBodyMethod ? 0 : body.size());
-        auto& gauge = sent_messages_size_bytes_gauge_family_ptr_->Add({{"source", source_}, {"method", method}});
-        gauge.Set(requestBodySize);
-        auto& histogram = sent_messages_size_bytes_histogram_family_ptr_->Add({{"source", source_}, {"method", method}}, message_size_bytes_histogram_bucket_boundaries_);
-        histogram.Observe(requestBodySize);
+        const SentMessageMetrics &sentMessageMetrics = sent_messages_metrics_->get(method);
+        sharded_metrics_->increment(sentMessageMetrics.observed_counter);
+
+        if (sampled) {
+            std::size_t requestBodySize = (noBodyMethod ? 0 : body.size());
+            sentMessageMetrics.size_bytes_gauge->Set(requestBodySize);
+            sharded_metrics_->observe(sentMessageMetrics.size_bytes_histogram, message_size_bytes_histogram_bucket_boundaries_, requestBodySize);
+        }
     }
 
     auto url = getUri(path);
@@ -205,6 +234,7 @@ void Http2Client::async_send(
     );
 
     auto task = std::make_shared<Http2Client::task>();
+    task->sampled = sampled;
     auto& ioContext = connection_->getIoContext();
 
     boost::asio::post(ioContext, [self, cb, noBodyMethod, requestTimeoutMs, task, url = std::move(url), method, headers, body, this]
@@ -240,8 +270,7 @@ void Http2Client::async_send(
 
                     // metrics
                     if (metrics_) {
-                        auto& counter = observed_responses_timedout_counter_family_ptr_->Add({{"source", source_}, {"method", method}});
-                        counter.Increment();
+                        sharded_metrics_->increment(responses_timedout_counters_->get(method));
                     }
 
                     // Optional: cancel HTTP/2 stream if possible
@@ -304,20 +333,20 @@ void Http2Client::async_send(
 
             // metrics
             if (metrics_) {
-                auto& counter = observed_responses_received_counter_family_ptr_->Add({{"source", source_}, {"method", method}, {"status_code", std::to_string(res.status_code())}});
-                counter.Increment();
+                const ResponseMetrics &responseMetrics = responses_metrics_->get(method, res.status_code());
+                sharded_metrics_->increment(responseMetrics.observed_counter);
 
                 task->receptionUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch());
-                double durationUs = (task->receptionUs - task->sendingUs).count();
-                double durationSeconds = durationUs/1000000.0;
-                LOGDEBUG(
-                    std::string msg = ert::tracing::Logger::asString("Context duration: %d us", durationUs);
-                    ert::tracing::Logger::debug(msg, ERT_FILE_LOCATION);
-                );
-                auto& gauge = responses_delay_seconds_gauge_family_ptr_->Add({{"source", source_}, {"method", method}, {"status_code", std::to_string(res.status_code())}});
-                gauge.Set(durationSeconds);
-                auto& histogram = responses_delay_seconds_histogram_family_ptr_->Add({{"source", source_}, {"method", method}, {"status_code", std::to_string(res.status_code())}}, response_delay_seconds_histogram_bucket_boundaries_);
-                histogram.Observe(durationSeconds);
+                if (task->sampled) {
+                    double durationUs = (task->receptionUs - task->sendingUs).count();
+                    double durationSeconds = durationUs/1000000.0;
+                    LOGDEBUG(
+                        std::string msg = ert::tracing::Logger::asString("Context duration: %d us", durationUs);
+                        ert::tracing::Logger::debug(msg, ERT_FILE_LOCATION);
+                    );
+                    responseMetrics.delay_seconds_gauge->Set(durationSeconds);
+                    sharded_metrics_->observe(responseMetrics.delay_seconds_histogram, response_delay_seconds_histogram_bucket_boundaries_, durationSeconds);
+                }
             }
 
             res.on_data(
@@ -344,12 +373,11 @@ void Http2Client::async_send(
                     LOGDEBUG(ert::tracing::Logger::debug(ert::tracing::Logger::asString(
                             "Request has been answered with status code: %d; data: %s; headers: %s", res.status_code(), task->data.c_str(), headersAsString(res.header()).c_str()), ERT_FILE_LOCATION));
                     // metrics
-                    if (metrics_) {
+                    if (task->sampled) {
+                        const ResponseMetrics &responseMetrics = responses_metrics_->get(method, res.status_code());
                         std::size_t responseBodySize = task->data.size();
-                        auto& gauge = received_messages_size_bytes_gauge_family_ptr_->Add({{"source", source_}, {"method", method}, {"status_code", std::to_string(res.status_code())}});
-                        gauge.Set(responseBodySize);
-                        auto& histogram = received_messages_size_bytes_histogram_family_ptr_->Add({{"source", source_}, {"method", method}, {"status_code", std::to_string(res.status_code())}}, message_size_bytes_histogram_bucket_boundaries_);
-                        histogram.Observe(responseBodySize);
+                        responseMetrics.size_bytes_gauge->Set(responseBodySize);
+                        sharded_metrics_->observe(responseMetrics.size_bytes_histogram, message_size_bytes_histogram_bucket_boundaries_, responseBodySize);
                     }
                 }
             });
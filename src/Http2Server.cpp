@@ -41,6 +41,9 @@ SOFTWARE.
 #include <sstream>
 #include <iostream>
 #include <memory>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <boost/exception/diagnostic_information.hpp>
 
 #include <ert/tracing/Logger.hpp>
@@ -51,31 +54,88 @@ SOFTWARE.
 #include <ert/http2comm/Http.hpp>
 #include <ert/http2comm/Http2Headers.hpp>
 #include <ert/http2comm/AsioCompat.hpp>
+#include <ert/http2comm/PriorityExecutor.hpp>
 
 namespace ert
 {
 namespace http2comm
 {
 
-Http2Server::Http2Server(const std::string &name, size_t workerThreads, size_t maxWorkerThreads, boost::asio::io_context *timersIoContext, int queueDispatcherMaxSize) : name_(name), timers_io_context_(timersIoContext), reception_id_(0), maximum_request_body_size_(0), queue_dispatcher_max_size_(queueDispatcherMaxSize >= -1 ? queueDispatcherMaxSize : -1)
+namespace
 {
+std::atomic<std::uint64_t> Http2ServerIds{};
 
-    queue_dispatcher_ = (workerThreads > 1) ? std::make_unique<ert::queuedispatcher::QueueDispatcher>(name + "_queueDispatcher", workerThreads, maxWorkerThreads) : nullptr;
+// Maximum idle streams pooled per nghttp2 io thread:
+const std::size_t StreamPoolMaxSize = 1024;
+
+// Queue delay limiters metrics sampling period:
+const std::chrono::milliseconds QueueDelaySamplingPeriod(100);
+}
+
+Http2Server::Http2Server(const std::string &name, size_t workerThreads, size_t maxWorkerThreads, boost::asio::io_context *timersIoContext, int queueDispatcherMaxSize, const std::chrono::microseconds &queueDelayTarget) : instance_id_(Http2ServerIds.fetch_add(1) + 1), name_(name), timers_io_context_(timersIoContext), worker_threads_(workerThreads), max_worker_threads_(maxWorkerThreads > workerThreads ? maxWorkerThreads : workerThreads), reception_id_(0), queue_dispatcher_max_size_(queueDispatcherMaxSize >= -1 ? queueDispatcherMaxSize : -1)
+{
+
+    if (timers_io_context_) {
+        timing_wheels_.push_back(std::make_unique<TimingWheel>(*timers_io_context_));
+    }
+
+    if (workerThreads > 1) {
+        executor_ = std::make_unique<QueueDispatcherExecutor>(name + "_queueDispatcher", workerThreads, maxWorkerThreads);
+    }
+
+    // Only applies to streams dispatched through the executor:
+    if (queueDelayTarget > std::chrono::microseconds::zero()) {
+        queue_delay_limiter_ = std::make_unique<QueueDelayLimiter>(queueDelayTarget, 20 * queueDelayTarget);
+    }
+}
+
+void Http2Server::setExecutor(std::unique_ptr<Executor> executor)
+{
+    autoscaler_.reset(); // refers to previous executor
+    executor_ = std::move(executor);
+
+    if (metrics_ && executor_) {
+        executor_->enableMetrics(metrics_, name_, source_);
+    }
+}
+
+bool Http2Server::enableAutoscaling(const AutoscalerConfig &config)
+{
+    if (max_worker_threads_ <= worker_threads_) return false;
+
+    autoscaler_.reset();
+
+    if (!executor_ || !executor_->setActiveThreads(worker_threads_)) {
+        // Only the default executor is replaced:
+        if (executor_ && !dynamic_cast<QueueDispatcherExecutor*>(executor_.get())) return false;
+
+        executor_ = std::make_unique<PriorityExecutor>(max_worker_threads_, 1);
+        if (metrics_) {
+            executor_->enableMetrics(metrics_, name_, source_);
+        }
+    }
+
+    autoscaler_ = std::make_unique<Autoscaler>(*executor_, worker_threads_, max_worker_threads_, config);
+    if (metrics_) {
+        autoscaler_->enableMetrics(metrics_, name_, source_);
+    }
+
+    return true;
 }
 
 int Http2Server::getQueueDispatcherBusyThreads() const
 {
-    return (queue_dispatcher_ ? queue_dispatcher_->getBusyThreads() : 0);
+    return (executor_ ? executor_->getBusyThreads() : 0);
 }
 
 int Http2Server::getQueueDispatcherThreads() const
 {
-    return (queue_dispatcher_ ? queue_dispatcher_->getThreads() : 0);
+    return (executor_ ? executor_->getThreads() : 0);
 }
 
 int Http2Server::getQueueDispatcherSize() const
 {
-    return (queue_dispatcher_ ? queue_dispatcher_->getSize() : 0);
+    return (executor_ ? executor_->getSize() : 0);
 }
 
 int Http2Server::getQueueDispatcherMaxSize() const
@@ -85,7 +145,9 @@ int Http2Server::getQueueDispatcherMaxSize() const
 
 void Http2Server::enableMetrics(ert::metrics::Metrics *metrics,
                                 const ert::metrics::bucket_boundaries_t &responseDelaySecondsHistogramBucketBoundaries,
-                                const ert::metrics::bucket_boundaries_t &messageSizeBytesHistogramBucketBoundaries, const std::string &source)
+                                const ert::metrics::bucket_boundaries_t &messageSizeBytesHistogramBucketBoundaries, const std::string &source,
+                                const std::chrono::milliseconds &shardedMetricsMergePeriod,
+                                unsigned int samplingRate)
 {
 
     metrics_ = metrics;
@@ -114,24 +176,451 @@ void Http2Server::enableMetrics(ert::metrics::Metrics *metrics,
 
         response_delay_seconds_histogram_bucket_boundaries_ = responseDelaySecondsHistogramBucketBoundaries;
         message_size_bytes_histogram_bucket_boundaries_ = messageSizeBytesHistogramBucketBoundaries;
+        sharded_metrics_ = std::make_unique<ShardedMetrics>(shardedMetricsMergePeriod);
+        metrics_sampler_ = MetricsSampler(samplingRate);
+
+        requests_accepted_counters_ = std::make_unique<MetricsCache<ert::metrics::counter_t*>>([this](const std::string &method, unsigned int) {
+            return &(observed_requests_accepted_counter_family_ptr_->Add({{"source", source_}, {"method", method}}));
+        });
+        requests_errored_counters_ = std::make_unique<MetricsCache<ert::metrics::counter_t*>>([this](const std::string &method, unsigned int) {
+            return &(observed_requests_errored_counter_family_ptr_->Add({{"source", source_}, {"method", method}}));
+        });
+        received_messages_metrics_ = std::make_unique<MetricsCache<ReceivedMessageMetrics>>([this](const std::string &method, unsigned int) {
+            ert::metrics::labels_t labels = {{"source", source_}, {"method", method}};
+            return ReceivedMessageMetrics{
+                &(received_messages_size_bytes_gauge_family_ptr_->Add(labels)),
+                &(received_messages_size_bytes_histogram_family_ptr_->Add(labels, message_size_bytes_histogram_bucket_boundaries_))
+            };
+        });
+        status_code_responses_metrics_ = createResponseMetricsCache("status_code");
+        error_code_responses_metrics_ = createResponseMetricsCache("rst_stream_goaway_error_code");
+
+        auto &streamPoolCounterFamily = metrics_->addCounterFamily(name_ + "_stream_pool_acquisitions_counter", "Stream pool acquisitions counter in " + name_, familyLabels);
+        stream_pool_hits_counter_ptr_ = &(streamPoolCounterFamily.Add({{"source", source_}, {"result", "hit"}}));
+        stream_pool_misses_counter_ptr_ = &(streamPoolCounterFamily.Add({{"source", source_}, {"result", "miss"}}));
+
+        requests_discarded_counter_ptr_ = &(metrics_->addCounterFamily(name_ + "_observed_requests_discarded_counter", "Requests discarded (stream reset before processing) observed counter in " + name_, familyLabels).Add({{"source", source_}}));
+
+        if (executor_) {
+            executor_->enableMetrics(metrics_, name_, source_);
+        }
+        if (autoscaler_) {
+            autoscaler_->enableMetrics(metrics_, name_, source_);
+        }
+        for (const auto &bulkhead : bulkheads_) {
+            if (bulkhead->executor) bulkhead->executor->enableMetrics(metrics_, name_ + "_" + bulkhead->name, source_);
+        }
+
+        if (queue_delay_limiter_) {
+            addQueueDelayLimiterMetrics(queue_delay_limiter_.get(), name_);
+        }
+        for (const auto &bulkhead : bulkheads_) {
+            if (bulkhead->queue_delay_limiter) addQueueDelayLimiterMetrics(bulkhead->queue_delay_limiter.get(), name_ + "_" + bulkhead->name);
+        }
+    }
+}
+
+Http2Server::~Http2Server()
+{
+    stopQueueDelaySampler(); // limiters are owned by the executors below
+
+    // Streams still queued, delayed or held are released while their pools (and the state used
+    // to recycle them) are alive. Executors are stopped first, as workers may hold or delay streams:
+    autoscaler_.reset();
+    executor_.reset();
+    bulkheads_.clear();
+    stopOwnedTimersIoContexts();
+
+    for (auto &shard : held_streams_) {
+        std::unordered_map<std::uint64_t, std::shared_ptr<Stream>> streams;
+        {
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            streams.swap(shard.streams);
+        }
+    }
+}
+
+void Http2Server::stopOwnedTimersIoContexts()
+{
+    owned_timers_work_guards_.clear();
+    for (auto &ioContext : owned_timers_io_contexts_) {
+        ioContext->stop();
+    }
+    for (auto &thread : owned_timers_threads_) {
+        if (thread.joinable()) thread.join();
+    }
+    owned_timers_threads_.clear();
+
+    // Wheels are destroyed before their io contexts:
+    timing_wheels_.clear();
+    owned_timers_io_contexts_.clear();
+}
+
+void Http2Server::hold(std::shared_ptr<Stream> stream)
+{
+    std::uint64_t receptionId = stream->getReceptionId();
+    HeldStreams &shard = held_streams_[receptionId % HeldStreamsShards];
+    {
+        // Closed check and insertion under the shard lock: on_close() marks the stream before
+        // unholding it, so either the stream is not indexed, or unhold() finds it:
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        if (stream->isClosed()) return;
+        shard.streams.emplace(receptionId, std::move(stream));
+    }
+
+    // Condition could be fulfilled meanwhile (release() called before holding):
+    if (responseDelayMs(receptionId) != HoldResponse) { // virtual
+        release(receptionId);
     }
 }
 
-Http2Server::~Http2Server() = default;
+std::shared_ptr<Stream> Http2Server::unhold(const std::uint64_t &receptionId)
+{
+    std::shared_ptr<Stream> result;
+
+    HeldStreams &shard = held_streams_[receptionId % HeldStreamsShards];
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto it = shard.streams.find(receptionId);
+    if (it != shard.streams.end()) {
+        result = std::move(it->second);
+        shard.streams.erase(it);
+    }
+
+    return result;
+}
 
-std::string Http2Server::getApiPath() const
+bool Http2Server::release(const std::uint64_t &receptionId)
 {
+    // Whoever removes the stream from the index commits it:
+    std::shared_ptr<Stream> stream = unhold(receptionId);
+    if (!stream) return false;
+
+    LOGDEBUG(
+        std::string msg = ert::tracing::Logger::asString("Server response released for reception identifier %llu", receptionId);
+        ert::tracing::Logger::debug(msg, ERT_FILE_LOCATION);
+    );
+
+    stream->commit();
+    return true;
+}
+
+void Http2Server::assignTimersIoContexts(const std::vector<boost::asio::io_context*> &ioContexts)
+{
+    timers_io_context_ = ioContexts.empty() ? nullptr : ioContexts.front();
+    for (auto ioContext : ioContexts) {
+        timing_wheels_.push_back(std::make_unique<TimingWheel>(*ioContext));
+    }
+}
+
+void Http2Server::setTimersIoContexts(const std::vector<boost::asio::io_context*> &ioContexts)
+{
+    stopOwnedTimersIoContexts();
+    assignTimersIoContexts(ioContexts);
+}
+
+void Http2Server::createTimersIoContexts(std::size_t number)
+{
+    stopOwnedTimersIoContexts();
+
+    std::vector<boost::asio::io_context*> ioContexts;
+    for (std::size_t k = 0; k < number; k++) {
+        owned_timers_io_contexts_.push_back(std::make_unique<boost::asio::io_context>(1 /* concurrency hint */));
+        owned_timers_work_guards_.push_back(boost::asio::make_work_guard(*(owned_timers_io_contexts_.back())));
+        ioContexts.push_back(owned_timers_io_contexts_.back().get());
+    }
+
+    assignTimersIoContexts(ioContexts);
+
+    for (auto ioContext : ioContexts) {
+        owned_timers_threads_.emplace_back([ioContext]() {
+            ioContext->run();
+        });
+    }
+}
+
+Http2Server::IoThreadContext &Http2Server::ioThreadContext()
+{
+    thread_local std::uint64_t instanceId{};
+    thread_local IoThreadContext *context{};
+
+    if (instanceId == instance_id_) return *context;
+
+    std::lock_guard<std::mutex> guard(io_thread_contexts_mutex_);
+    std::thread::id threadId = std::this_thread::get_id();
+    context = nullptr;
+    for (auto &it : io_thread_contexts_) {
+        if (it->thread_id == threadId) {
+            context = it.get();
+            break;
+        }
+    }
+
+    if (!context) {
+        io_thread_contexts_.push_back(std::make_unique<IoThreadContext>());
+        context = io_thread_contexts_.back().get();
+        context->thread_id = threadId;
+        context->stream_pool = std::make_shared<StreamPool>(this, StreamPoolMaxSize);
+    }
+
+    instanceId = instance_id_;
+    return *context;
+}
+
+std::unique_ptr<MetricsCache<Http2Server::ResponseMetrics>> Http2Server::createResponseMetricsCache(const std::string &resultCodeLabel)
+{
+    return std::make_unique<MetricsCache<ResponseMetrics>>([this, resultCodeLabel](const std::string &method, unsigned int code) {
+        ert::metrics::labels_t labels = {{"source", source_}, {"method", method}, {resultCodeLabel, std::to_string(code)}};
+        return ResponseMetrics{
+            &(observed_responses_counter_family_ptr_->Add(labels)),
+            &(responses_delay_seconds_gauge_family_ptr_->Add(labels)),
+            &(sent_messages_size_bytes_gauge_family_ptr_->Add(labels)),
+            &(responses_delay_seconds_histogram_family_ptr_->Add(labels, response_delay_seconds_histogram_bucket_boundaries_)),
+            &(sent_messages_size_bytes_histogram_family_ptr_->Add(labels, message_size_bytes_histogram_bucket_boundaries_))
+        };
+    });
+}
+
+bool Http2Server::queueDelayDrop(QueueDelayLimiter *limiter, const std::chrono::microseconds &sojourn)
+{
+    // metrics are sampled (see sampleQueueDelayLimiters())
+    return (limiter && limiter->drop(sojourn));
+}
+
+void Http2Server::addQueueDelayLimiterMetrics(QueueDelayLimiter *limiter, const std::string &name)
+{
+    ert::metrics::labels_t familyLabels = {};
+    QueueDelayLimiterMetrics limiterMetrics{
+        limiter,
+        &(metrics_->addGaugeFamily(name + "_queue_delay_limit_seconds_gauge", "Queue delay limit gauge (seconds) in " + name, familyLabels).Add({{"source", source_}})),
+        &(metrics_->addCounterFamily(name + "_queue_delay_dropped_requests_counter", "Requests dropped by queue delay limiter counter in " + name, familyLabels).Add({{"source", source_}})),
+        limiter->getDropped()
+    };
+    limiterMetrics.limit_seconds_gauge->Set(limiter->getLimit().count() / 1000000.0);
+    if (limiterMetrics.dropped > 0) limiterMetrics.dropped_requests_counter->Increment(limiterMetrics.dropped);
+
+    std::lock_guard<std::mutex> lock(queue_delay_sampler_mutex_);
+    queue_delay_limiters_metrics_.push_back(limiterMetrics);
+    if (!queue_delay_sampler_.joinable()) {
+        queue_delay_sampler_ = std::thread(&Http2Server::sampleQueueDelayLimiters, this);
+    }
+}
+
+void Http2Server::sampleQueueDelayLimiters()
+{
+    std::unique_lock<std::mutex> lock(queue_delay_sampler_mutex_);
+    for (;;) {
+        bool stopped = queue_delay_sampler_cv_.wait_for(lock, QueueDelaySamplingPeriod, [this]() {
+            return queue_delay_sampler_stopped_;
+        });
+        if (stopped) return;
+
+        for (auto &limiterMetrics : queue_delay_limiters_metrics_) {
+            limiterMetrics.limiter->refresh();
+            limiterMetrics.limit_seconds_gauge->Set(limiterMetrics.limiter->getLimit().count() / 1000000.0);
+
+            std::uint64_t dropped = limiterMetrics.limiter->getDropped();
+            if (dropped > limiterMetrics.dropped) {
+                limiterMetrics.dropped_requests_counter->Increment(dropped - limiterMetrics.dropped);
+                limiterMetrics.dropped = dropped;
+            }
+        }
+    }
+}
+
+void Http2Server::stopQueueDelaySampler()
+{
+    {
+        std::lock_guard<std::mutex> lock(queue_delay_sampler_mutex_);
+        queue_delay_sampler_stopped_ = true;
+    }
+    queue_delay_sampler_cv_.notify_all();
+
+    if (queue_delay_sampler_.joinable()) queue_delay_sampler_.join();
+}
+
+void Http2Server::buildCongestionResponse()
+{
+    // Same response than default receiveError() implementation (cause needs no escaping):
+    congestion_response_body_ = "{\"cause\":\"" + ert::http2comm::SERVICE_UNAVAILABLE.second + "\"}";
+
+    Http2Headers hdrs;
+    hdrs.addVersion(getApiVersion());
+    hdrs.addContentLength(congestion_response_body_.size());
+    hdrs.addContentType("application/problem+json");
+    congestion_response_headers_ = hdrs.getHeaders();
+}
+
+bool Http2Server::congestion(Executor *executor, int queueMaxSize, unsigned int priority) const
+{
+    // Congestion control enabled, no idle consumers and queue (ahead of the priority class) over the maximum size:
+    return (executor && queueMaxSize >= 0 && executor->congested(queueMaxSize, priority));
+}
+
+std::size_t Http2Server::addBulkhead(const std::string &name, size_t workerThreads, size_t maxWorkerThreads, int queueMaxSize, const std::chrono::microseconds &queueDelayTarget)
+{
+    return addBulkhead(name, std::make_unique<QueueDispatcherExecutor>(name_ + "_" + name + "_queueDispatcher", workerThreads, maxWorkerThreads), queueMaxSize, queueDelayTarget);
+}
+
+std::size_t Http2Server::addBulkhead(const std::string &name, std::unique_ptr<Executor> executor, int queueMaxSize, const std::chrono::microseconds &queueDelayTarget)
+{
+    auto bulkhead = std::make_unique<Bulkhead>();
+    bulkhead->name = name;
+    bulkhead->executor = std::move(executor);
+    bulkhead->queue_max_size = (queueMaxSize >= -1 ? queueMaxSize : -1);
+    if (queueDelayTarget > std::chrono::microseconds::zero()) {
+        bulkhead->queue_delay_limiter = std::make_unique<QueueDelayLimiter>(queueDelayTarget, 20 * queueDelayTarget);
+    }
+
+    if (metrics_ && bulkhead->executor) {
+        bulkhead->executor->enableMetrics(metrics_, name_ + "_" + name, source_);
+    }
+    if (metrics_ && bulkhead->queue_delay_limiter) {
+        addQueueDelayLimiterMetrics(bulkhead->queue_delay_limiter.get(), name_ + "_" + name);
+    }
+
+    bulkheads_.push_back(std::move(bulkhead));
+    return bulkheads_.size();
+}
+
+bool Http2Server::addBulkheadRule(std::size_t bulkhead, const std::string &method, const std::string &pathPrefix)
+{
+    if (bulkhead == 0 || bulkhead > bulkheads_.size()) return false;
+
+    bulkheads_[bulkhead - 1]->rules.emplace_back(method, pathPrefix);
+    return true;
+}
+
+std::size_t Http2Server::bulkhead(const nghttp2::asio_http2::server::request& req)
+{
+    for (std::size_t k = 0; k < bulkheads_.size(); k++) {
+        for (const auto &rule : bulkheads_[k]->rules) {
+            if (!rule.first.empty() && rule.first != req.method()) continue;
+            if (!rule.second.empty() && !ert::http2comm::URLFunctions::matchPrefix(req.uri().path, rule.second)) continue;
+            return k + 1;
+        }
+    }
+
+    return 0;
+}
+
+unsigned int Http2Server::priority(const nghttp2::asio_http2::server::request& req)
+{
+    if (priority_header_.empty()) return default_priority_;
+
+    auto it = req.header().find(priority_header_);
+    if (it == req.header().end()) return default_priority_;
+
+    // Plain number, or urgency parameter of RFC 9218 priority field ('u=3, i'):
+    const std::string &value = it->second.value;
+    std::size_t pos = 0;
+    if (value.empty() || !std::isdigit((unsigned char)value[0])) {
+        pos = value.find("u=");
+        if (pos == std::string::npos) return default_priority_;
+        pos += 2;
+    }
+    if (pos >= value.size() || !std::isdigit((unsigned char)value[pos])) return default_priority_;
+
+    return std::strtoul(value.c_str() + pos, nullptr, 10);
+}
+
+Executor *Http2Server::getBulkheadExecutor(std::size_t bulkhead) const
+{
+    if (bulkhead == 0) return executor_.get();
+    if (bulkhead > bulkheads_.size()) return nullptr;
+
+    return bulkheads_[bulkhead - 1]->executor.get();
+}
+
+void Http2Server::updateStaticRoutes(std::shared_ptr<const static_routes_t> routes)
+{
+    // Version is increased after the store, so readers detecting the new version load the new table:
+    std::atomic_store(&static_routes_, std::move(routes));
+    static_routes_version_.fetch_add(1, std::memory_order_release);
+}
+
+void Http2Server::addStaticRoute(const std::string &method, const std::string &path, unsigned int statusCode,
+                                 const nghttp2::asio_http2::header_map &headers, const std::string &body)
+{
+    StaticResponse response{statusCode, std::make_shared<const nghttp2::asio_http2::header_map>(headers), std::make_shared<const std::string>(body)};
+
+    std::lock_guard<std::mutex> guard(static_routes_mutex_);
+    auto current = std::atomic_load(&static_routes_);
+    auto routes = current ? std::make_shared<static_routes_t>(*current) : std::make_shared<static_routes_t>();
+
+    auto &methods = (*routes)[path];
+    auto it = std::find_if(methods.begin(), methods.end(), [&method](const std::pair<std::string, StaticResponse> &entry) {
+        return entry.first == method;
+    });
+    if (it != methods.end()) {
+        it->second = std::move(response);
+    }
+    else {
+        methods.emplace_back(method, std::move(response));
+    }
+
+    updateStaticRoutes(std::move(routes));
+}
+
+bool Http2Server::removeStaticRoute(const std::string &method, const std::string &path)
+{
+    std::lock_guard<std::mutex> guard(static_routes_mutex_);
+    auto current = std::atomic_load(&static_routes_);
+    if (!current) return false;
+
+    auto pathIt = current->find(path);
+    if (pathIt == current->end()) return false;
+
+    auto routes = std::make_shared<static_routes_t>(*current);
+    auto &methods = (*routes)[path];
+    auto it = std::find_if(methods.begin(), methods.end(), [&method](const std::pair<std::string, StaticResponse> &entry) {
+        return entry.first == method;
+    });
+    if (it == methods.end()) return false;
+
+    methods.erase(it);
+    if (methods.empty()) routes->erase(path);
+
+    updateStaticRoutes(routes->empty() ? nullptr : std::move(routes));
+    return true;
+}
+
+void Http2Server::clearStaticRoutes()
+{
+    std::lock_guard<std::mutex> guard(static_routes_mutex_);
+    updateStaticRoutes(nullptr);
+}
+
+const Http2Server::StaticResponse *Http2Server::findStaticRoute(IoThreadContext &context, const nghttp2::asio_http2::server::request &req)
+{
+    std::uint64_t version = static_routes_version_.load(std::memory_order_acquire);
+    if (context.static_routes_version != version) {
+        context.static_routes = std::atomic_load(&static_routes_);
+        context.static_routes_version = version;
+    }
+
+    if (!context.static_routes) return nullptr;
+
+    auto pathIt = context.static_routes->find(req.uri().path);
+    if (pathIt == context.static_routes->end()) return nullptr;
+
+    for (const auto &entry : pathIt->second) {
+        if (entry.first == req.method()) return &(entry.second);
+    }
+
+    return nullptr;
+}
+
+void Http2Server::updateApiPath()
+{
+    api_path_.clear();
     if (api_name_.empty())
-        return {};
+        return;
 
-    std::ostringstream oss;
-    oss << "/" << api_name_;
+    api_path_ = "/" + api_name_;
 
     if (!api_version_.empty()) {
-        oss << "/" << api_version_;
+        api_path_ += "/" + api_version_;
     }
-
-    return oss.str();
 }
 
 void Http2Server::receiveError(const nghttp2::asio_http2::server::request &req,
@@ -146,8 +635,7 @@ void Http2Server::receiveError(const nghttp2::asio_http2::server::request &req,
     // metrics
     if (metrics_)
     {
-        auto &counter = observed_requests_errored_counter_family_ptr_->Add({{"source", source_}, {"method", req.method()}});
-        counter.Increment();
+        sharded_metrics_->increment(requests_errored_counters_->get(req.method()));
     }
 
     statusCode = error.first;
@@ -211,6 +699,18 @@ void Http2Server::receiveError(const nghttp2::asio_http2::server::request &req,
     headers = hdrs.getHeaders();
 }
 
+void Http2Server::receive(const std::uint64_t &receptionId,
+                          const nghttp2::asio_http2::server::request& req,
+                          const std::string &requestBody,
+                          const std::chrono::microseconds &receptionTimestampUs,
+                          unsigned int& statusCode,
+                          nghttp2::asio_http2::header_map& headers,
+                          std::string& responseBody,
+                          unsigned int &responseDelayMs)
+{
+    receiveError(req, requestBody, statusCode, headers, responseBody, ert::http2comm::METHOD_NOT_IMPLEMENTED);
+}
+
 void Http2Server::streamError(uint32_t errorCode, const std::string &serverName, const std::uint64_t &receptionId, const nghttp2::asio_http2::server::request &req)
 {
     std::string msg = ert::tracing::Logger::asString("Error code: %d | Server: %s | Reception id: %llu | Request Method: %s | Request Uri: %s", errorCode, serverName.c_str(), receptionId, req.method().c_str(), req.uri().path.c_str());
@@ -222,51 +722,104 @@ nghttp2::asio_http2::server::request_cb Http2Server::handler()
     return [&](const nghttp2::asio_http2::server::request &req,
                const nghttp2::asio_http2::server::response &res)
     {
-        auto stream = std::make_shared<Stream>(req, res, this);
-        req.on_data([stream, this](const uint8_t *data, std::size_t len)
+        IoThreadContext &context = ioThreadContext();
+        bool poolHit{};
+        auto stream = context.stream_pool->acquire(req, res, poolHit);
+
+        // metrics
+        if (metrics_) {
+            sharded_metrics_->increment(poolHit ? stream_pool_hits_counter_ptr_ : stream_pool_misses_counter_ptr_);
+        }
+
+        const bool streaming = streamRequestBody(req); // virtual
+        if (streaming) {
+            receiveHeaders(req); // virtual
+        }
+
+        req.on_data([stream, streaming, &context, this](const uint8_t *data, std::size_t len)
         {
             if (len > 0) // https://stackoverflow.com/a/72925875/2576671
             {
-                if (receiveDataLen(stream->getReq())) {
+                if (streaming) {
+                    stream->addStreamedDataLen(len);
+                    receiveChunk(stream->getReq(), data, len); // virtual
+                }
+                else if (receiveDataLen(stream->getReq())) {
                     // https://github.com/testillano/h2agent/issues/6 is caused when this is enabled, on high load and broke client connections:
                     // (mutexes does not solves the problem neither std::move of data, and does not matter is shared_ptr requestBody is replaced
                     // by static type; it seems that data is not correctly protected on lower layers, probably tatsuhiro-t nghttp2)
                     stream->appendData(data, len);
-
-                    // Update maximum request body size registered
-                    if (preReserveRequestBody()) {
-                        std::size_t current = maximum_request_body_size_.load();
-                        while (len > current && !maximum_request_body_size_.compare_exchange_weak(current, len));
-                    }
                 }
             }
             else
             {
+                if (streaming) {
+                    receiveEnd(stream->getReq()); // virtual
+                }
+
                 std::uint64_t receptionId = reception_id_.fetch_add(1) + 1;
                 stream->setReceptionId(receptionId);
 
-                if (queue_dispatcher_) {
-                    queue_dispatcher_->dispatch(stream);
+                // Static routes are answered here, bypassing the whole processing
+                if (const StaticResponse *response = findStaticRoute(context, stream->getReq())) {
+                    stream->respond(response->status_code, *(response->headers), response->body);
+                    return;
                 }
-                else {
+
+                // Executor selection (default one, or a bulkhead):
+                Executor *executor = executor_.get();
+                int queueMaxSize = queue_dispatcher_max_size_;
+                QueueDelayLimiter *queueDelayLimiter = queue_delay_limiter_.get();
+                Autoscaler *autoscaler = autoscaler_.get();
+                if (!bulkheads_.empty()) {
+                    std::size_t index = bulkhead(stream->getReq()); // virtual
+                    if (index > 0 && index <= bulkheads_.size()) {
+                        const Bulkhead &selected = *(bulkheads_[index - 1]);
+                        executor = selected.executor.get();
+                        queueMaxSize = selected.queue_max_size;
+                        queueDelayLimiter = selected.queue_delay_limiter.get();
+                        autoscaler = nullptr;
+                    }
+                }
+
+                // Cheap requests (or every request when there is no dispatcher) are processed here:
+                if (!executor || processInline(stream->getReq())) { // virtual
                     stream->reception();
                     stream->commit();
+                    return;
                 }
+
+                // Priority class (only for executors supporting them):
+                unsigned int priorityClass = 0;
+                if (executor->getPriorities() > 1) {
+                    priorityClass = priority(stream->getReq()); // virtual
+                    if (priorityClass >= executor->getPriorities()) priorityClass = executor->getPriorities() - 1;
+                }
+
+                // Admission control: congested requests are answered here, before being queued
+                if (congestion(executor, queueMaxSize, priorityClass)) {
+                    stream->reject();
+                    return;
+                }
+
+                stream->setDispatchTimestamp(std::chrono::steady_clock::now(), queueDelayLimiter, autoscaler);
+                executor->dispatch(stream, priorityClass);
             }
         });
 
         res.on_close([stream, this](uint32_t error_code)
         {
-            stream->cancelTimer();
-
+            // Stream is marked before cancelling delays, so a concurrent hold() can not index it afterwards:
             if (error_code != 0)
             {
                 stream->error(error_code);
+                stream->cancelTimer();
                 streamError(error_code, name_, reception_id_, stream->getReq()); // virtual
             }
             else
             {
                 stream->close();
+                stream->cancelTimer();
                 streamClose(stream->getReceptionId()); // virtual
             }
         });
@@ -285,6 +838,7 @@ int Http2Server::serve(const std::string &bind_address,
 
     boost::system::error_code ec;
 
+    buildCongestionResponse();
     server_.handle("/", handler());
     registerHandlers(); // virtual hook for derived classes to register additional handlers
     server_.num_threads(numberThreads);
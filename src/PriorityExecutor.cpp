@@ -0,0 +1,202 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <ert/http2comm/PriorityExecutor.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+PriorityExecutor::PriorityExecutor(std::size_t threads, unsigned int priorities, unsigned int starvationLimit) : starvation_limit_(starvationLimit)
+{
+    if (threads == 0) threads = 1;
+    if (priorities == 0) priorities = 1;
+
+    queues_.resize(priorities);
+    skipped_.resize(priorities);
+    sizes_ = std::make_unique<std::atomic<int>[]>(priorities);
+    for (unsigned int k = 0; k < priorities; k++) sizes_[k].store(0);
+
+    active_.store(threads);
+    threads_.reserve(threads);
+    for (std::size_t k = 0; k < threads; k++) {
+        threads_.emplace_back(&PriorityExecutor::run, this, (int)k);
+    }
+}
+
+PriorityExecutor::~PriorityExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    cv_.notify_all();
+    parked_cv_.notify_all();
+
+    for (auto &thread : threads_) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+void PriorityExecutor::dispatch(std::shared_ptr<ert::queuedispatcher::StreamIf> stream)
+{
+    dispatch(std::move(stream), queues_.size() - 1);
+}
+
+void PriorityExecutor::dispatch(std::shared_ptr<ert::queuedispatcher::StreamIf> stream, unsigned int priority)
+{
+    if (priority >= queues_.size()) priority = queues_.size() - 1;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queues_[priority].push_back(std::move(stream));
+        sizes_[priority].fetch_add(1, std::memory_order_relaxed);
+        size_.fetch_add(1, std::memory_order_relaxed);
+    }
+    cv_.notify_one();
+}
+
+bool PriorityExecutor::take(std::shared_ptr<ert::queuedispatcher::StreamIf> &stream)
+{
+    // Highest priority class with streams, unless a lower one is starving:
+    unsigned int selected = queues_.size();
+    for (unsigned int k = 0; k < queues_.size(); k++) {
+        if (queues_[k].empty()) continue;
+        if (selected == queues_.size()) {
+            selected = k;
+        }
+        else if (skipped_[k] >= starvation_limit_) {
+            selected = k;
+            break;
+        }
+    }
+    if (selected == queues_.size()) return false;
+
+    // Lower classes waiting are skipped once more:
+    for (unsigned int k = selected + 1; k < queues_.size(); k++) {
+        if (!queues_[k].empty()) skipped_[k]++;
+    }
+    skipped_[selected] = 0;
+
+    stream = std::move(queues_[selected].front());
+    queues_[selected].pop_front();
+    sizes_[selected].fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+void PriorityExecutor::run(int index)
+{
+    for (;;) {
+        std::shared_ptr<ert::queuedispatcher::StreamIf> stream;
+        int size;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            // Parked while over active threads (dispatch notifications only reach active workers):
+            parked_cv_.wait(lock, [this, index]() {
+                return index < active_.load(std::memory_order_relaxed) || stopped_;
+            });
+
+            cv_.wait(lock, [this, index]() {
+                return size_.load(std::memory_order_relaxed) > 0 || index >= active_.load(std::memory_order_relaxed) || stopped_;
+            });
+            if (stopped_) return;
+            if (index >= active_.load(std::memory_order_relaxed)) {
+                // Deactivated: the notification consumed could be a dispatch one, so it is passed on
+                if (size_.load(std::memory_order_relaxed) > 0) cv_.notify_one();
+                continue;
+            }
+            if (!take(stream)) continue;
+            size = size_.fetch_sub(1) - 1;
+        }
+
+        int busy = busy_.fetch_add(1) + 1;
+        stream->process(busy >= active_.load(std::memory_order_relaxed), size);
+        stream.reset();
+        busy_.fetch_sub(1);
+    }
+}
+
+unsigned int PriorityExecutor::getPriorities() const
+{
+    return queues_.size();
+}
+
+int PriorityExecutor::getBusyThreads() const
+{
+    return busy_.load(std::memory_order_relaxed);
+}
+
+int PriorityExecutor::getThreads() const
+{
+    return active_.load(std::memory_order_relaxed);
+}
+
+bool PriorityExecutor::setActiveThreads(std::size_t threads)
+{
+    if (threads == 0) threads = 1;
+    if (threads > threads_.size()) threads = threads_.size();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_.store(threads, std::memory_order_relaxed);
+    }
+    parked_cv_.notify_all(); // parked workers now active take pending streams
+    cv_.notify_all(); // active workers now over the limit are parked
+
+    return true;
+}
+
+int PriorityExecutor::getSize() const
+{
+    return size_.load(std::memory_order_relaxed);
+}
+
+int PriorityExecutor::getSizeAhead(unsigned int priority) const
+{
+    if (priority >= queues_.size()) priority = queues_.size() - 1;
+
+    int result = 0;
+    for (unsigned int k = 0; k <= priority; k++) result += sizes_[k].load(std::memory_order_relaxed);
+    return result;
+}
+
+}
+}
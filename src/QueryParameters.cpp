@@ -0,0 +1,119 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <functional>
+
+#include <ert/http2comm/QueryParameters.hpp>
+#include <ert/http2comm/URLFunctions.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+QueryParameters::QueryParameters(std::size_t cacheSize, char separator) : cache_size_(cacheSize), separator_(separator)
+{
+    index_.reserve(cacheSize);
+}
+
+void QueryParameters::parse(std::string_view rawQuery, Canonical &canonical, char separator)
+{
+    canonical.parameters.clear();
+    canonical.query.clear();
+
+    QueryTokenizer tokenizer(rawQuery, separator);
+    std::string_view key, value;
+    while (tokenizer.next(key, value)) {
+        canonical.parameters.emplace_back(URLFunctions::decode(key), URLFunctions::decode(value));
+    }
+
+    std::sort(canonical.parameters.begin(), canonical.parameters.end());
+    canonical.parameters.erase(std::unique(canonical.parameters.begin(), canonical.parameters.end()), canonical.parameters.end());
+
+    for (const auto &parameter : canonical.parameters) {
+        if (!canonical.query.empty()) canonical.query += separator;
+        URLFunctions::encode(parameter.first, canonical.query);
+        if (!parameter.second.empty()) {
+            canonical.query += '=';
+            URLFunctions::encode(parameter.second, canonical.query);
+        }
+    }
+}
+
+std::shared_ptr<const QueryParameters::Canonical> QueryParameters::canonical(std::string_view rawQuery)
+{
+    std::size_t hash = std::hash<std::string_view>()(rawQuery);
+
+    if (cache_size_ > 0) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = index_.find(hash);
+        if (it != index_.end() && it->second->raw_query == rawQuery) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return it->second->canonical;
+        }
+    }
+
+    // Parsing out of the lock:
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    auto result = std::make_shared<Canonical>();
+    parse(rawQuery, *result, separator_);
+
+    if (cache_size_ > 0) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = index_.find(hash);
+        if (it != index_.end()) { // hash collision, or inserted meanwhile: replaced
+            lru_.erase(it->second);
+            index_.erase(it);
+        }
+        else if (lru_.size() >= cache_size_) {
+            index_.erase(lru_.back().hash);
+            lru_.pop_back();
+        }
+
+        lru_.push_front(Entry{hash, std::string(rawQuery), result});
+        index_.emplace(hash, lru_.begin());
+    }
+
+    return result;
+}
+
+}
+}
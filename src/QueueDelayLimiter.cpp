@@ -0,0 +1,100 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <limits>
+
+#include <ert/http2comm/QueueDelayLimiter.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+QueueDelayLimiter::QueueDelayLimiter(const std::chrono::microseconds &target, const std::chrono::microseconds &interval) :
+    target_us_(target.count()), interval_us_(interval.count()), min_delay_us_(std::numeric_limits<std::int64_t>::max())
+{
+}
+
+namespace
+{
+std::int64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+void QueueDelayLimiter::evaluate(std::int64_t nowUs)
+{
+    // An interval without streams has no minimum delay, so it is not overloaded:
+    std::int64_t intervalEnd = interval_end_us_.load(std::memory_order_relaxed);
+    if (nowUs >= intervalEnd && interval_end_us_.compare_exchange_strong(intervalEnd, nowUs + interval_us_, std::memory_order_relaxed)) {
+        std::int64_t minDelayUs = min_delay_us_.exchange(std::numeric_limits<std::int64_t>::max(), std::memory_order_relaxed);
+        overloaded_.store(intervalEnd != 0 /* first interval just started */ && minDelayUs != std::numeric_limits<std::int64_t>::max() && minDelayUs > target_us_, std::memory_order_relaxed);
+    }
+}
+
+bool QueueDelayLimiter::drop(const std::chrono::microseconds &sojourn)
+{
+    std::int64_t delayUs = sojourn.count();
+
+    // Minimum delay along the current interval:
+    std::int64_t current = min_delay_us_.load(std::memory_order_relaxed);
+    while (delayUs < current && !min_delay_us_.compare_exchange_weak(current, delayUs, std::memory_order_relaxed));
+
+    evaluate(nowUs());
+
+    bool result = (delayUs > (isOverloaded() ? target_us_ : interval_us_));
+    if (result) dropped_.fetch_add(1, std::memory_order_relaxed);
+
+    return result;
+}
+
+void QueueDelayLimiter::refresh()
+{
+    if (interval_end_us_.load(std::memory_order_relaxed) == 0) return; // no streams yet
+    evaluate(nowUs());
+}
+
+std::chrono::microseconds QueueDelayLimiter::getLimit() const
+{
+    return std::chrono::microseconds(isOverloaded() ? target_us_ : interval_us_);
+}
+
+}
+}
@@ -0,0 +1,212 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+
+#include <ert/http2comm/Router.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+namespace
+{
+const std::array<std::string_view, 9> Methods = { "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH" };
+}
+
+// Static prefixes are compressed (radix), and children are indexed by their first character.
+// Parameter child (at most one) matches a whole path segment:
+struct Router::Node {
+    std::string prefix{};
+    std::string indices{};
+    std::vector<std::unique_ptr<Node>> children{};
+    std::unique_ptr<Node> parameter{};
+    std::string name{}; // parameter nodes
+
+    std::array<handler_t, Methods.size()> handlers{};
+    std::vector<std::string> allowed_methods{};
+};
+
+std::string_view Router::Parameters::get(std::string_view name) const
+{
+    for (std::size_t k = 0; k < size_; k++) {
+        if (parameters_[k].first == name) return parameters_[k].second;
+    }
+
+    return std::string_view();
+}
+
+Router::Router() : root_(std::make_unique<Node>())
+{
+}
+
+Router::~Router() = default;
+
+int Router::methodIndex(std::string_view method)
+{
+    for (std::size_t k = 0; k < Methods.size(); k++) {
+        if (Methods[k] == method) return k;
+    }
+
+    return -1;
+}
+
+bool Router::add(const std::string &method, const std::string &pattern, handler_t handler)
+{
+    int index = methodIndex(method);
+    if (index < 0 || pattern.empty() || pattern[0] != '/') return false;
+
+    // Parameters must be whole segments:
+    std::size_t parametersNumber = 0;
+    for (std::size_t pos = pattern.find('{'); pos != std::string::npos; pos = pattern.find('{', pos + 1)) {
+        if (pattern[pos - 1] != '/') return false;
+        if (++parametersNumber > MaxParameters) return false;
+    }
+
+    Node *node = root_.get();
+    std::string_view path = pattern;
+
+    while (!path.empty()) {
+        if (path[0] == '{') {
+            std::size_t end = path.find('}');
+            if (end == std::string_view::npos) return false;
+            std::string_view name = path.substr(1, end - 1);
+            if (name.empty() || name.find_first_of("/{") != std::string_view::npos) return false;
+            path.remove_prefix(end + 1);
+            if (!path.empty() && path[0] != '/') return false;
+
+            if (!node->parameter) {
+                node->parameter = std::make_unique<Node>();
+                node->parameter->name = name;
+            }
+            else if (node->parameter->name != name) {
+                return false;
+            }
+
+            node = node->parameter.get();
+            continue;
+        }
+
+        std::string_view label = path.substr(0, path.find('{'));
+        std::size_t pos = node->indices.find(label[0]);
+
+        if (pos == std::string::npos) {
+            node->indices += label[0];
+            node->children.push_back(std::make_unique<Node>());
+            node = node->children.back().get();
+            node->prefix = label;
+            path.remove_prefix(label.size());
+            continue;
+        }
+
+        // Common prefix with existing child, which is split when partially shared:
+        Node *child = node->children[pos].get();
+        std::size_t common = 0;
+        while (common < label.size() && common < child->prefix.size() && label[common] == child->prefix[common]) common++;
+
+        if (common < child->prefix.size()) {
+            auto middle = std::make_unique<Node>();
+            middle->prefix = child->prefix.substr(0, common);
+            child->prefix.erase(0, common);
+            middle->indices += child->prefix[0];
+            middle->children.push_back(std::move(node->children[pos]));
+            node->children[pos] = std::move(middle);
+            child = node->children[pos].get();
+        }
+
+        node = child;
+        path.remove_prefix(common);
+    }
+
+    if (!node->handlers[index]) {
+        node->allowed_methods.push_back(method);
+    }
+    node->handlers[index] = std::move(handler);
+    empty_ = false;
+
+    return true;
+}
+
+const Router::Node *Router::find(const Node *node, std::string_view path, Parameters &parameters) const
+{
+    if (path.empty()) {
+        return (node->allowed_methods.empty() ? nullptr : node);
+    }
+
+    // Static child first:
+    std::size_t pos = node->indices.find(path[0]);
+    if (pos != std::string::npos) {
+        const Node *child = node->children[pos].get();
+        if (path.compare(0, child->prefix.size(), child->prefix) == 0) {
+            if (const Node *result = find(child, path.substr(child->prefix.size()), parameters)) return result;
+        }
+    }
+
+    // Then parameter (whole segment):
+    if (node->parameter) {
+        std::string_view value = path.substr(0, path.find('/'));
+        if (!value.empty()) {
+            parameters.push(node->parameter->name, value);
+            if (const Node *result = find(node->parameter.get(), path.substr(value.size()), parameters)) return result;
+            parameters.pop();
+        }
+    }
+
+    return nullptr;
+}
+
+Router::Result Router::find(std::string_view method, std::string_view path, Match &match) const
+{
+    int index = methodIndex(method);
+
+    if (path.empty()) path = "/";
+
+    const Node *node = find(root_.get(), path, match.parameters);
+    if (!node) return (index < 0 ? MethodNotImplemented : NotFound);
+
+    match.allowed_methods = &(node->allowed_methods);
+    if (index < 0 || !node->handlers[index]) return MethodNotAllowed;
+
+    match.handler = &(node->handlers[index]);
+    return Found;
+}
+
+}
+}
@@ -0,0 +1,166 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <atomic>
+
+#include <ert/http2comm/ShardedMetrics.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+namespace
+{
+std::atomic<std::uint64_t> ShardedMetricsIds{};
+}
+
+ShardedMetrics::ShardedMetrics(const std::chrono::milliseconds &mergePeriod) : id_(ShardedMetricsIds.fetch_add(1) + 1), merge_period_(mergePeriod)
+{
+    if (merge_period_ <= std::chrono::milliseconds::zero()) return;
+
+    merger_ = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(merger_mutex_);
+        while (!merger_cv_.wait_for(lock, merge_period_, [this] { return stop_; })) {
+            lock.unlock();
+            merge();
+            lock.lock();
+        }
+    });
+}
+
+ShardedMetrics::~ShardedMetrics()
+{
+    if (merger_.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(merger_mutex_);
+            stop_ = true;
+        }
+        merger_cv_.notify_one();
+        merger_.join();
+        merge();
+    }
+}
+
+ShardedMetrics::Shard &ShardedMetrics::localShard()
+{
+    // Shards are owned by both the thread and this object, so they survive any of them:
+    thread_local std::unordered_map<std::uint64_t, std::shared_ptr<Shard>> threadShards;
+    thread_local std::uint64_t lastId{};
+    thread_local Shard *lastShard{};
+
+    if (lastId == id_) return *lastShard;
+
+    std::shared_ptr<Shard> &shard = threadShards[id_];
+    if (!shard) {
+        shard = std::make_shared<Shard>();
+        std::lock_guard<std::mutex> guard(shards_mutex_);
+        shards_.push_back(shard);
+    }
+
+    lastId = id_;
+    lastShard = shard.get();
+    return *lastShard;
+}
+
+void ShardedMetrics::increment(ert::metrics::counter_t *counter, double value)
+{
+    if (!merger_.joinable()) {
+        counter->Increment(value);
+        return;
+    }
+
+    Shard &shard = localShard();
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    shard.counters[counter] += value;
+}
+
+void ShardedMetrics::observe(ert::metrics::histogram_t *histogram, const ert::metrics::bucket_boundaries_t &boundaries, double value)
+{
+    if (!merger_.joinable()) {
+        histogram->Observe(value);
+        return;
+    }
+
+    Shard &shard = localShard();
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    PendingHistogram &pending = shard.histograms[histogram];
+    if (!pending.boundaries) {
+        pending.boundaries = &boundaries;
+        pending.buckets.resize(boundaries.size() + 1 /* +Inf */);
+    }
+
+    // Same bucket selection than prometheus (first boundary greater or equal than value):
+    std::size_t bucket = std::lower_bound(boundaries.begin(), boundaries.end(), value) - boundaries.begin();
+    pending.buckets[bucket] += 1;
+    pending.sum += value;
+    pending.count++;
+}
+
+void ShardedMetrics::merge()
+{
+    std::vector<std::shared_ptr<Shard>> shards;
+    {
+        std::lock_guard<std::mutex> guard(shards_mutex_);
+        shards = shards_;
+    }
+
+    for (auto &shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->mutex);
+
+        for (auto &it : shard->counters) {
+            if (it.second == 0) continue;
+            it.first->Increment(it.second);
+            it.second = 0;
+        }
+
+        for (auto &it : shard->histograms) {
+            PendingHistogram &pending = it.second;
+            if (pending.count == 0) continue;
+            it.first->ObserveMultiple(pending.buckets, pending.sum);
+            std::fill(pending.buckets.begin(), pending.buckets.end(), 0);
+            pending.sum = 0;
+            pending.count = 0;
+        }
+    }
+}
+
+}
+}
@@ -36,6 +36,9 @@ LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
+#include <algorithm>
+#include <cstdlib>
+
 #include <nghttp2/asio_http2_server.h>
 
 #include <ert/tracing/Logger.hpp>
@@ -50,11 +53,77 @@ namespace ert
 {
 namespace http2comm
 {
+
+namespace
+{
+// Recycled streams release body buffers larger than this factor times current size class:
+const std::size_t BodyShrinkFactor = 4;
+
+// 'content-length' header is untrusted (a peer could force large reservations without sending the data),
+// so its reservation is limited to what recycled streams keep (or this minimum), and larger bodies grow
+// as data arrives:
+const std::size_t MinContentLengthReservationLimit = 16 * 1024;
+}
+
 Stream::Stream(const nghttp2::asio_http2::server::request& req,
                const nghttp2::asio_http2::server::response& res,
-               Http2Server *server) : req_(req), res_(res), server_(server), closed_(false), error_(false), timer_(nullptr), need_timer_(false) {
+               Http2Server *server) : req_(&req), res_(&res), server_(server), closed_(false), error_(false), timer_([this]() { timerExpired(); }), need_timer_(false) {
+}
+
+void Stream::reuse(const nghttp2::asio_http2::server::request& req,
+                   const nghttp2::asio_http2::server::response& res) {
+    req_ = &req;
+    res_ = &res;
+    closed_ = false;
+    error_ = false;
+    status_code_ = 0;
+    need_timer_ = false;
+    timer_scheduled_ = false;
+    need_hold_ = false;
+    held_ = false;
+    reception_timestamp_us_ = std::chrono::microseconds::zero();
+    reception_id_ = 0;
+
+    // Already reserved capacity is kept:
+    request_body_.clear();
+    streamed_body_size_ = 0;
+    response_body_.clear();
+    response_body_size_ = 0;
+}
+
+void Stream::recycle() {
+    // Body sizes statistics, and release of buffers much larger than current size classes:
+    if (!request_body_.empty()) server_->request_body_size_estimator_.observe(request_body_.size());
+    if (request_body_.capacity() > BodyShrinkFactor * server_->request_body_size_estimator_.getSizeClass()) {
+        std::string().swap(request_body_);
+    }
+    if (response_body_size_ != 0) server_->response_body_size_estimator_.observe(response_body_size_);
+    if (response_body_.capacity() > BodyShrinkFactor * server_->response_body_size_estimator_.getSizeClass()) {
+        std::string().swap(response_body_);
+    }
 
-    if (server_->preReserveRequestBody()) request_body_.reserve(server_->maximum_request_body_size_.load());
+    // Release resources not worth keeping:
+    req_ = nullptr;
+    res_ = nullptr;
+    response_headers_.clear();
+    response_source_.clear();
+}
+
+void Stream::reserveRequestBody() {
+    std::size_t size = 0;
+    std::size_t sizeClass = server_->request_body_size_estimator_.getSizeClass();
+
+    auto it = req_->header().find("content-length");
+    if (it != req_->header().end()) {
+        size = std::strtoull(it->second.value.c_str(), nullptr, 10);
+        std::size_t limit = std::max(BodyShrinkFactor * sizeClass, MinContentLengthReservationLimit);
+        if (size > limit) size = limit;
+    }
+    if (size == 0) {
+        size = sizeClass;
+    }
+
+    request_body_.reserve(size);
 }
 
 void Stream::appendData(const uint8_t* data, std::size_t len) {
@@ -63,12 +132,35 @@ void Stream::appendData(const uint8_t* data, std::size_t len) {
     //
     // BUT: std::string append has better performance than stringstream one (https://gist.github.com/testillano/bc8944eec86fe4e857bf51d61d6c5e42):
     if (data && len > 0) {
+        if (request_body_.empty() && server_->preReserveRequestBody()) {
+            reserveRequestBody();
+        }
         request_body_.append((const char *)data, len);
     }
 }
 
 void Stream::process(bool busyConsumers, int queueSize) {
-    reception(server_->getQueueDispatcherMaxSize() >= 0 /* congestion control enabled */ && busyConsumers && queueSize > server_->getQueueDispatcherMaxSize());
+    // Streams reset by the client while queued are discarded: nobody would read the response
+    // (and nghttp2 request structure is not valid anymore):
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (closed_ || error_) {
+            if (server_->metrics_) {
+                server_->sharded_metrics_->increment(server_->requests_discarded_counter_ptr_);
+            }
+            LOGDEBUG(
+                std::string msg = ert::tracing::Logger::asString("Discarding reception identifier %llu: stream already closed", reception_id_);
+                ert::tracing::Logger::debug(msg, ERT_FILE_LOCATION);
+            );
+            return;
+        }
+    }
+
+    // Congestion control by queue size is already done on admission (Http2Server handler),
+    // but queueing delay is only known here:
+    auto queueDelay = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - dispatch_timestamp_);
+    if (autoscaler_) autoscaler_->observe(queueDelay);
+    reception(server_->queueDelayDrop(queue_delay_limiter_, queueDelay));
     commit();
 }
 
@@ -78,28 +170,33 @@ void Stream::reception(bool congestion)
 
     std::vector<std::string> allowedMethods;
     unsigned int responseDelayMs{};
+    response_source_.resume = ResumeHandle(weak_from_this());
 
     if (congestion)
     {
-        server_->receiveError(req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::SERVICE_UNAVAILABLE);
+        server_->receiveError(*req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::SERVICE_UNAVAILABLE);
     }
-    else if (!server_->checkMethodIsAllowed(req_, allowedMethods))
+    else if (!server_->router_.empty())
     {
-        server_->receiveError(req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::METHOD_NOT_ALLOWED, "", allowedMethods);
+        route(responseDelayMs);
     }
-    else if (!server_->checkMethodIsImplemented(req_))
+    else if (!server_->checkMethodIsAllowed(*req_, allowedMethods))
     {
-        server_->receiveError(req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::METHOD_NOT_IMPLEMENTED);
+        server_->receiveError(*req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::METHOD_NOT_ALLOWED, "", allowedMethods);
+    }
+    else if (!server_->checkMethodIsImplemented(*req_))
+    {
+        server_->receiveError(*req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::METHOD_NOT_IMPLEMENTED);
     }
     else
     {
-        if (server_->checkHeaders(req_))
+        if (server_->checkHeaders(*req_))
         {
-            std::string apiPath = server_->getApiPath();
+            const std::string &apiPath = server_->getApiPath();
 
-            if (apiPath != "" && !ert::http2comm::URLFunctions::matchPrefix(req_.uri().path, apiPath))
+            if (!apiPath.empty() && !ert::http2comm::URLFunctions::matchPrefix(req_->uri().path, apiPath))
             {
-                server_->receiveError(req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::WRONG_API_NAME_OR_VERSION);
+                server_->receiveError(*req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::WRONG_API_NAME_OR_VERSION);
             }
             else
             {
@@ -107,46 +204,51 @@ void Stream::reception(bool congestion)
 
                 // metrics
                 if (server_->metrics_) {
-                    auto& counter = server_->observed_requests_accepted_counter_family_ptr_->Add({{"source", server_->source_}, {"method", req_.method()}});
-                    counter.Increment();
+                    server_->sharded_metrics_->increment(server_->requests_accepted_counters_->get(req_->method()));
                 }
 
-                server_->receive(reception_id_, req_, request_body_, reception_timestamp_us_, status_code_, response_headers_, response_body_, responseDelayMs);
+                server_->receiveSource(reception_id_, *req_, request_body_, reception_timestamp_us_, status_code_, response_headers_, response_body_, response_source_, responseDelayMs);
             }
         }
         else
         {
-            server_->receiveError(req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::UNSUPPORTED_MEDIA_TYPE);
+            server_->receiveError(*req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::UNSUPPORTED_MEDIA_TYPE);
         }
     }
 
+    // Streamed sizes are accumulated on commit():
+    response_body_size_ = (response_source_.generator ? 0 : (response_source_.body ? response_source_.body->size() : response_body_.size()));
+
     // Optional reponse delay
     bool ioContextWarning = false;
     if (responseDelayMs != 0) { // provision delay
-        if (server_->getTimersIoContext()) {
-            //if (!server_->getTimersIoContext()->stopped()) {
-            timer_ = std::make_shared<boost::asio::steady_timer>(*(server_->getTimersIoContext()), std::chrono::milliseconds(responseDelayMs));
+        if (server_->timingWheel(reception_id_)) {
+            timer_delay_ = std::chrono::milliseconds(responseDelayMs);
             need_timer_ = true;
             LOGDEBUG(
                 std::string msg = ert::tracing::Logger::asString("Server response delay scheduled (%d ms)", responseDelayMs);
                 ert::tracing::Logger::debug(msg, ERT_FILE_LOCATION);
             );
-            //}
         }
         else {
             ioContextWarning = true;
         }
     }
     else if (std::chrono::milliseconds delayMs = server_->responseDelayMs(reception_id_); delayMs > std::chrono::milliseconds::zero()) { // reception-id specific delay
-        if (server_->getTimersIoContext()) {
-            //if (!server_->getTimersIoContext()->stopped()) {
-            timer_ = std::make_shared<boost::asio::steady_timer>(*(server_->getTimersIoContext()), delayMs);
+        if (delayMs == Http2Server::HoldResponse) {
+            need_hold_ = true;
+            LOGDEBUG(
+                std::string msg = ert::tracing::Logger::asString("Server response held for reception identifier %llu", reception_id_);
+                ert::tracing::Logger::debug(msg, ERT_FILE_LOCATION);
+            );
+        }
+        else if (server_->timingWheel(reception_id_)) {
+            timer_delay_ = delayMs;
             need_timer_ = true;
             LOGDEBUG(
                 std::string msg = ert::tracing::Logger::asString("Server responseDelayMs() scheduled (%d ms) for reception identifier %llu", delayMs.count(), reception_id_);
                 ert::tracing::Logger::debug(msg, ERT_FILE_LOCATION);
             );
-            //}
         }
         else {
             ioContextWarning = true;
@@ -156,29 +258,97 @@ void Stream::reception(bool congestion)
     LOGWARNING(if (ioContextWarning) ert::tracing::Logger::warning("You must provide an 'io context for timers' in order to manage delays in http2 server", ERT_FILE_LOCATION));
 }
 
-void Stream::commit()
+void Stream::route(unsigned int &responseDelayMs)
 {
-    if (need_timer_)
+    // API path prefix (same normalization than virtual chain), routes are relative to it:
+    std::string_view path = req_->uri().path;
+    const std::string &apiPath = server_->getApiPath();
+    bool apiMatch = ert::http2comm::URLFunctions::matchPrefix(path, apiPath);
+
+    Router::Match match;
+    Router::Result result;
+    if (apiMatch) {
+        result = server_->router_.find(req_->method(), path.substr(std::min(apiPath.size(), path.size())), match);
+    }
+    else {
+        result = (Router::methodIndex(req_->method()) < 0 ? Router::MethodNotImplemented : Router::NotFound);
+    }
+
+    // Same precedence than virtual chain (405, 501, 415, 400), and then 404 (receive()):
+    if (result == Router::MethodNotAllowed)
+    {
+        server_->receiveError(*req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::METHOD_NOT_ALLOWED, "", *(match.allowed_methods));
+    }
+    else if (result == Router::MethodNotImplemented)
+    {
+        server_->receiveError(*req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::METHOD_NOT_IMPLEMENTED);
+    }
+    else if (!server_->checkHeaders(*req_))
+    {
+        server_->receiveError(*req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::UNSUPPORTED_MEDIA_TYPE);
+    }
+    else if (!apiMatch)
+    {
+        server_->receiveError(*req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::WRONG_API_NAME_OR_VERSION);
+    }
+    else if (result == Router::NotFound)
+    {
+        server_->receiveError(*req_, request_body_, status_code_, response_headers_, response_body_, ert::http2comm::WRONG_URI);
+    }
+    else
     {
-        timer_->async_wait([this] (const boost::system::error_code& ec) {
+        // VALID RECEPTION
 
-            if (ec == boost::asio::error::operation_aborted) { // timer was cancelled, we musn't commit
-                return;
-            }
+        // metrics
+        if (server_->metrics_) {
+            server_->sharded_metrics_->increment(server_->requests_accepted_counters_->get(req_->method()));
+        }
 
-            // Re-scheduling of timers by mean virtual server responseDelayMs():
-            std::chrono::milliseconds delayMs = server_->responseDelayMs(reception_id_);
-            need_timer_ = (delayMs > std::chrono::milliseconds::zero());
-            if (need_timer_) {
-                timer_->expires_after(delayMs);
-                LOGDEBUG(
-                    std::string msg = ert::tracing::Logger::asString("Server responseDelayMs() re-scheduled (%d ms) for reception identifier %llu", delayMs.count(), reception_id_);
-                    ert::tracing::Logger::debug(msg, ERT_FILE_LOCATION);
-                );
-            }
+        (*match.handler)(reception_id_, *req_, request_body_, match.parameters, reception_timestamp_us_, status_code_, response_headers_, response_body_, response_source_, responseDelayMs);
+    }
+}
+
+void Stream::timerExpired()
+{
+    // Re-scheduling of timers by mean virtual server responseDelayMs():
+    std::chrono::milliseconds delayMs = server_->responseDelayMs(reception_id_);
+    need_hold_ = (delayMs == Http2Server::HoldResponse);
+    need_timer_ = (delayMs > std::chrono::milliseconds::zero() && !need_hold_);
+    if (need_timer_) {
+        timer_delay_ = delayMs;
+        LOGDEBUG(
+            std::string msg = ert::tracing::Logger::asString("Server responseDelayMs() re-scheduled (%d ms) for reception identifier %llu", delayMs.count(), reception_id_);
+            ert::tracing::Logger::debug(msg, ERT_FILE_LOCATION);
+        );
+    }
+
+    commit();
+}
+
+void Stream::commit()
+{
+    if (need_timer_)
+    {
+        // Not scheduled once closed, as cancelTimer() (on close) only cancels timers already scheduled.
+        // Cancelled timers never expire:
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (closed_ || error_) return;
+        timer_scheduled_ = true;
+        server_->timingWheel(reception_id_)->schedule(timer_, timer_delay_);
+        return;
+    }
 
-            commit();
-        });
+    if (need_hold_)
+    {
+        // Committed again by Http2Server::release(). Not held once closed, as cancelTimer() (on close)
+        // only unholds streams marked here (hold() also checks it, under the held shard lock):
+        need_hold_ = false;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            if (closed_ || error_) return;
+            held_ = true;
+        }
+        server_->hold(shared_from_this());
         return;
     }
 
@@ -188,11 +358,14 @@ void Stream::commit()
         return;
     }
 
-    auto self = this;
-    //auto self = shared_from_this();
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        held_ = false;
+    }
+    auto self = shared_from_this(); // owned until the response is sent: never recycled (StreamPool) with the handler queued
 
-    // Send response
-    boost::asio::post(ert::http2comm::asio_compat::io_context(res_), [self]()
+    // Send response (immediately when already running on the nghttp2 io thread, i.e. inline processing)
+    boost::asio::dispatch(ert::http2comm::asio_compat::io_context(*res_), [self]()
     {
         try {
             std::lock_guard<std::mutex> guard(self->mutex_);
@@ -216,11 +389,28 @@ void Stream::commit()
                 // 0xB    STREAM_CLOSED         Reception of frame already closed
                 // ---
                 // Correspond to 'nghttp2_error_code' enum type within 'https://nghttp2.org/documentation/nghttp2.h.html'
-                self->res_.cancel(self->status_code_); // this will be passed to on_close() as error_code
+                self->res_->cancel(self->status_code_); // this will be passed to on_close() as error_code
             }
             else {
-                self->res_.write_head(self->status_code_, self->response_headers_);
-                self->res_.end(self->response_body_);
+                self->res_->write_head(self->status_code_, self->response_source_.headers ? *(self->response_source_.headers) : self->response_headers_);
+                if (self->response_source_.empty()) {
+                    self->res_->end(self->response_body_);
+                }
+                else if (!self->response_source_.generator) {
+                    // Shared immutable body: no per-request copies
+                    self->res_->end(ResponseSource::bodyGenerator(std::move(self->response_source_.body)));
+                    self->response_source_.clear();
+                }
+                else {
+                    // Streaming response: bytes generated are accumulated for metrics
+                    // (generator is only called from this io thread, until stream close)
+                    self->res_->end([self, generator = std::move(self->response_source_.generator)](uint8_t *buf, std::size_t len, uint32_t *data_flags) -> ssize_t {
+                        ssize_t result = generator(buf, len, data_flags);
+                        if (result > 0) self->response_body_size_ += result;
+                        return result;
+                    });
+                    self->response_source_.clear();
+                }
             }
         }
         catch (const std::exception& e) {
@@ -229,13 +419,80 @@ void Stream::commit()
     });
 }
 
-void Stream::updateMetrics(const char *resultCodeLabel) {
+void Stream::resume()
+{
+    // Response structure is valid until stream is closed (checked under the lock in both sides):
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (closed_ || error_) return;
+
+    boost::asio::post(ert::http2comm::asio_compat::io_context(*res_), [self = shared_from_this()]()
+    {
+        std::lock_guard<std::mutex> guard(self->mutex_);
+        if (!self->closed_ && !self->error_) {
+            self->res_->resume();
+        }
+    });
+}
+
+void Stream::reject()
+{
+    reception_timestamp_us_ = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch());
+    status_code_ = ert::http2comm::ResponseCode::SERVICE_UNAVAILABLE;
+    response_body_size_ = server_->congestion_response_body_.size();
+
+    // metrics
+    if (server_->metrics_) {
+        server_->sharded_metrics_->increment(server_->requests_errored_counters_->get(req_->method()));
+    }
+
+    LOGDEBUG(
+        std::string msg = ert::tracing::Logger::asString("Congestion detected: reception identifier %llu rejected", reception_id_);
+        ert::tracing::Logger::debug(msg, ERT_FILE_LOCATION);
+    );
+
+    try {
+        res_->write_head(status_code_, server_->congestion_response_headers_);
+        res_->end(server_->congestion_response_body_);
+    }
+    catch (const std::exception& e) {
+        LOGWARNING(ert::tracing::Logger::warning("Exception in response reject: " + std::string(e.what()), ERT_FILE_LOCATION));
+    }
+}
+
+void Stream::respond(unsigned int statusCode, const nghttp2::asio_http2::header_map &headers, const std::shared_ptr<const std::string> &body)
+{
+    reception_timestamp_us_ = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch());
+    status_code_ = statusCode;
+    response_body_size_ = body->size();
+
+    // metrics
+    if (server_->metrics_) {
+        server_->sharded_metrics_->increment(server_->requests_accepted_counters_->get(req_->method()));
+    }
+
+    try {
+        res_->write_head(status_code_, headers);
+        res_->end(ResponseSource::bodyGenerator(body));
+    }
+    catch (const std::exception& e) {
+        LOGWARNING(ert::tracing::Logger::warning("Exception in static response: " + std::string(e.what()), ERT_FILE_LOCATION));
+    }
+}
+
+void Stream::updateMetrics(bool transportError) {
     if (!server_->metrics_) return;
 
-    // Cache status code string conversion
-    std::string statusCodeStr = std::to_string(status_code_);
+    const Http2Server::ResponseMetrics &responseMetrics = (transportError ? server_->error_code_responses_metrics_ : server_->status_code_responses_metrics_)->get(req_->method(), status_code_);
+    ShardedMetrics &shardedMetrics = *(server_->sharded_metrics_);
+
+    // counters
+    shardedMetrics.increment(responseMetrics.observed_counter);
+
+    // gauges & histograms (sampled)
+    if (!server_->metrics_sampler_.sample()) return;
+
+    const Http2Server::ReceivedMessageMetrics &receivedMessageMetrics = server_->received_messages_metrics_->get(req_->method());
 
-    // histograms
     auto finalUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
     double durationUs = finalUs - reception_timestamp_us_.count();
     double durationSeconds = durationUs/1000000.0;
@@ -244,27 +501,17 @@ void Stream::updateMetrics(const char *resultCodeLabel) {
         ert::tracing::Logger::debug(msg, ERT_FILE_LOCATION);
     );
 
-    auto& gauge = server_->responses_delay_seconds_gauge_family_ptr_->Add({{"source", server_->source_}, {"method", req_.method()}, {resultCodeLabel, statusCodeStr}});
-    gauge.Set(durationSeconds);
+    responseMetrics.delay_seconds_gauge->Set(durationSeconds);
 
-    std::size_t requestBodySize = request_body_.size();
-    std::size_t responseBodySize = response_body_.size();
+    std::size_t requestBodySize = request_body_.size() + streamed_body_size_;
+    std::size_t responseBodySize = response_body_size_;
 
-    auto& gauge2 = server_->received_messages_size_bytes_gauge_family_ptr_->Add({{"source", server_->source_}, {"method", req_.method()}});
-    gauge2.Set(requestBodySize);
-    auto& gauge3 = server_->sent_messages_size_bytes_gauge_family_ptr_->Add({{"source", server_->source_}, {"method", req_.method()}, {resultCodeLabel, statusCodeStr}});
-    gauge3.Set(responseBodySize);
+    receivedMessageMetrics.size_bytes_gauge->Set(requestBodySize);
+    responseMetrics.size_bytes_gauge->Set(responseBodySize);
 
-    auto& histogram = server_->responses_delay_seconds_histogram_family_ptr_->Add({{"source", server_->source_}, {"method", req_.method()}, {resultCodeLabel, statusCodeStr}}, server_->response_delay_seconds_histogram_bucket_boundaries_);
-    histogram.Observe(durationSeconds);
-    auto& histogram2 = server_->received_messages_size_bytes_histogram_family_ptr_->Add({{"source", server_->source_}, {"method", req_.method()}}, server_->message_size_bytes_histogram_bucket_boundaries_);
-    histogram2.Observe(requestBodySize);
-    auto& histogram3 = server_->sent_messages_size_bytes_histogram_family_ptr_->Add({{"source", server_->source_}, {"method", req_.method()}, {resultCodeLabel, statusCodeStr}}, server_->message_size_bytes_histogram_bucket_boundaries_);
-    histogram3.Observe(responseBodySize);
-
-    // counters
-    auto& counter = server_->observed_responses_counter_family_ptr_->Add({{"source", server_->source_}, {"method", req_.method()}, {resultCodeLabel, statusCodeStr}});
-    counter.Increment();
+    shardedMetrics.observe(responseMetrics.delay_seconds_histogram, server_->response_delay_seconds_histogram_bucket_boundaries_, durationSeconds);
+    shardedMetrics.observe(receivedMessageMetrics.size_bytes_histogram, server_->message_size_bytes_histogram_bucket_boundaries_, requestBodySize);
+    shardedMetrics.observe(responseMetrics.size_bytes_histogram, server_->message_size_bytes_histogram_bucket_boundaries_, responseBodySize);
 }
 
 void Stream::error(uint32_t error_code) {
@@ -272,19 +519,39 @@ void Stream::error(uint32_t error_code) {
     error_ = true;
 
     status_code_ = error_code;
-    updateMetrics("rst_stream_goaway_error_code");
+    updateMetrics(true);
 }
 
 void Stream::close() {
     std::lock_guard<std::mutex> guard(mutex_);
     closed_ = true;
 
-    updateMetrics("status_code");
+    updateMetrics(false);
+}
+
+bool Stream::isClosed() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return (closed_ || error_);
 }
 
 void Stream::cancelTimer() {
-    if (timer_) {
-        timer_->cancel();
+    // Called after close() or error(), so no timer is scheduled afterwards. Most transactions are
+    // never delayed, so the (shared) wheel lock is skipped for them:
+    bool scheduled, held;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        scheduled = timer_scheduled_;
+        held = held_;
+    }
+
+    if (scheduled) {
+        if (TimingWheel *timingWheel = server_->timingWheel(reception_id_)) {
+            timingWheel->cancel(timer_);
+        }
+    }
+
+    if (held) {
+        server_->unhold(reception_id_);
     }
 }
 
@@ -0,0 +1,142 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <new>
+
+#include <ert/http2comm/StreamPool.hpp>
+#include <ert/http2comm/Stream.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+StreamPool::StreamPool(Http2Server *server, std::size_t maxSize) : server_(server), max_size_(maxSize)
+{
+    streams_.reserve(max_size_);
+    blocks_.reserve(max_size_);
+}
+
+StreamPool::~StreamPool()
+{
+    // Idle streams release their last control block (weak reference) into the pool, so blocks go after:
+    std::vector<Stream*> streams;
+    streams.swap(streams_);
+    for (auto stream : streams) delete stream;
+    for (auto block : blocks_) ::operator delete(block);
+}
+
+void *StreamPool::allocateBlock(std::size_t size)
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (block_size_ == 0) block_size_ = size;
+        if (size == block_size_ && !blocks_.empty()) {
+            void *block = blocks_.back();
+            blocks_.pop_back();
+            return block;
+        }
+    }
+
+    return ::operator new(size);
+}
+
+void StreamPool::deallocateBlock(void *block, std::size_t size)
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (size == block_size_ && blocks_.size() < max_size_) {
+            blocks_.push_back(block);
+            return;
+        }
+    }
+
+    ::operator delete(block);
+}
+
+void StreamPool::release(Stream *stream)
+{
+    stream->recycle();
+
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (streams_.size() < max_size_) {
+            streams_.push_back(stream);
+            return;
+        }
+    }
+
+    delete stream;
+}
+
+std::shared_ptr<Stream> StreamPool::acquire(const nghttp2::asio_http2::server::request& req,
+        const nghttp2::asio_http2::server::response& res,
+        bool &hit)
+{
+    Stream *stream = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (!streams_.empty()) {
+            stream = streams_.back();
+            streams_.pop_back();
+        }
+    }
+
+    hit = (stream != nullptr);
+    if (hit) {
+        stream->reuse(req, res);
+    }
+    else {
+        stream = new Stream(req, res, server_);
+    }
+
+    StreamPool *pool = this;
+    return std::shared_ptr<Stream>(stream, [pool](Stream *s) {
+        pool->release(s);
+    }, Allocator<Stream>(this));
+}
+
+std::size_t StreamPool::size()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    return streams_.size();
+}
+
+}
+}
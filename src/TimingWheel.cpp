@@ -0,0 +1,256 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <ert/http2comm/TimingWheel.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+TimingWheel::TimingWheel(boost::asio::io_context &ioContext) : guard_(std::make_shared<Guard>()), driver_(ioContext), origin_(std::chrono::steady_clock::now())
+{
+    guard_->wheel = this;
+
+    for (auto &list : level0_) init(list);
+    for (auto &level : levels_) {
+        for (auto &list : level) init(list);
+    }
+    init(expired_);
+}
+
+TimingWheel::~TimingWheel()
+{
+    // Waits for a tick in progress, and detaches queued handlers:
+    {
+        std::lock_guard<std::mutex> guard(guard_->mutex);
+        guard_->wheel = nullptr;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    stopped_ = true;
+    driver_.cancel();
+}
+
+std::uint64_t TimingWheel::now() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - origin_).count();
+}
+
+void TimingWheel::init(Link &list)
+{
+    list.prev = &list;
+    list.next = &list;
+}
+
+void TimingWheel::append(Link &list, Link *link)
+{
+    link->prev = list.prev;
+    link->next = &list;
+    list.prev->next = link;
+    list.prev = link;
+}
+
+void TimingWheel::unlink(Link *link)
+{
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link->prev = nullptr;
+    link->next = nullptr;
+}
+
+void TimingWheel::insert(Timer *timer)
+{
+    std::uint64_t expiry = timer->expiry_;
+    std::uint64_t delta = (expiry > current_) ? (expiry - current_) : 0;
+
+    if (delta < Level0Size) {
+        // Expired ones (delta zero) are processed on next tick:
+        append(level0_[(delta ? expiry : current_) & (Level0Size - 1)], timer);
+        return;
+    }
+
+    // Longer delays are placed at the last slot reachable, and cascaded again later:
+    if (delta > MaxDelta) expiry = current_ + MaxDelta;
+
+    int level = (delta < (std::uint64_t(1) << (Level0Bits + LevelBits))) ? 0 : (delta < (std::uint64_t(1) << (Level0Bits + 2 * LevelBits))) ? 1 : 2;
+    append(levels_[level][(expiry >> (Level0Bits + level * LevelBits)) & (LevelSize - 1)], timer);
+}
+
+void TimingWheel::cascade(std::array<Link, LevelSize> &level, std::uint64_t index)
+{
+    Link &list = level[index];
+    while (list.next != &list) {
+        Link *link = list.next;
+        unlink(link);
+        insert(static_cast<Timer*>(link));
+    }
+}
+
+void TimingWheel::schedule(Timer &timer, const std::chrono::milliseconds &delay)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (stopped_) return;
+
+    if (timer.next) {
+        unlink(&timer);
+        if (timer.pending_) size_--;
+    }
+
+    // Idle wheel just catches up with current time (nothing to expire):
+    std::uint64_t nowTick = now();
+    if (size_ == 0) current_ = nowTick;
+
+    timer.expiry_ = nowTick + (delay.count() > 0 ? delay.count() : 0);
+    insert(&timer);
+    timer.pending_ = true;
+    size_++;
+
+    if (!running_) {
+        running_ = true;
+        boost::asio::post(driver_.get_executor(), [guard = guard_]() {
+            std::lock_guard<std::mutex> wheelGuard(guard->mutex);
+            TimingWheel *wheel = guard->wheel;
+            if (!wheel) return;
+
+            std::lock_guard<std::mutex> lock(wheel->mutex_);
+            if (!wheel->stopped_) wheel->arm();
+        });
+    }
+}
+
+bool TimingWheel::cancel(Timer &timer)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (timer.next) {
+        unlink(&timer);
+        if (timer.pending_) size_--;
+        timer.pending_ = false;
+        return true;
+    }
+
+    // Wait for callback completion (unless cancelled from the callback itself):
+    if (firing_thread_ != std::this_thread::get_id()) {
+        firing_cv_.wait(lock, [this, &timer]() {
+            return firing_ != &timer;
+        });
+    }
+
+    return false;
+}
+
+std::size_t TimingWheel::size() const
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    return size_;
+}
+
+void TimingWheel::arm()
+{
+    // Next tick to process (at 'current_' milliseconds from origin):
+    driver_.expires_at(origin_ + std::chrono::milliseconds(current_));
+    driver_.async_wait([guard = guard_](const boost::system::error_code& ec) {
+        if (ec == boost::asio::error::operation_aborted) return;
+
+        std::lock_guard<std::mutex> wheelGuard(guard->mutex);
+        if (guard->wheel) guard->wheel->tick();
+    });
+}
+
+void TimingWheel::tick()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopped_) return;
+
+    // Advance up to current time, collecting expired timers:
+    std::uint64_t nowTick = now();
+    while (current_ <= nowTick && size_ > 0) {
+        std::uint64_t index = current_ & (Level0Size - 1);
+
+        // Cascade upper levels when the lower one completes a turn:
+        if (index == 0) {
+            for (int level = 0; level < 3; level++) {
+                std::uint64_t levelIndex = (current_ >> (Level0Bits + level * LevelBits)) & (LevelSize - 1);
+                cascade(levels_[level], levelIndex);
+                if (levelIndex != 0) break;
+            }
+        }
+
+        Link &list = level0_[index];
+        while (list.next != &list) {
+            Link *link = list.next;
+            unlink(link);
+            append(expired_, link);
+            static_cast<Timer*>(link)->pending_ = false;
+            size_--;
+        }
+
+        current_++;
+    }
+    if (size_ == 0 && current_ <= nowTick) current_ = nowTick + 1;
+
+    // Callbacks executed out of the lock (cancellation waits for the one in progress):
+    while (expired_.next != &expired_) {
+        Timer *timer = static_cast<Timer*>(expired_.next);
+        unlink(timer);
+        firing_ = timer;
+        firing_thread_ = std::this_thread::get_id();
+        lock.unlock();
+
+        timer->callback_();
+
+        lock.lock();
+        firing_ = nullptr;
+        firing_thread_ = std::thread::id();
+        firing_cv_.notify_all();
+    }
+
+    if (stopped_) return;
+
+    if (size_ > 0) {
+        arm();
+    }
+    else {
+        running_ = false;
+    }
+}
+
+}
+}
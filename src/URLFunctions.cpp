@@ -38,10 +38,14 @@ SOFTWARE.
 */
 
 
+#include <algorithm>
 #include <string>
-#include <regex>
-#include <cctype>
-//#include <iomanip>
+#include <array>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
 
 
 #include <ert/http2comm/URLFunctions.hpp>
@@ -51,92 +55,385 @@ namespace ert
 namespace http2comm
 {
 
+namespace
+{
 const char UPPER_XDIGITS[] = "0123456789ABCDEF";
-std::string URLFunctions::encode(const std::string& decodedUrl)
+
+// Unreserved characters (RFC3986): ALPHA / DIGIT / "-" / "." / "_" / "~"
+constexpr std::array<bool, 256> buildUnreserved() {
+    std::array<bool, 256> result{};
+    for (int c = 0; c < 256; c++) {
+        result[c] = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.' || c == '~';
+    }
+    return result;
+}
+constexpr std::array<bool, 256> Unreserved = buildUnreserved();
+
+// Hexadecimal digit values (-1 for non hexadecimal digits)
+constexpr std::array<signed char, 256> buildHexValues() {
+    std::array<signed char, 256> result{};
+    for (int c = 0; c < 256; c++) {
+        result[c] = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+    }
+    return result;
+}
+constexpr std::array<signed char, 256> HexValues = buildHexValues();
+
+// Sparse escaping: at most one escape (or '+' when decoding) every 'MinMeanRun' characters on average,
+// sampled on the first 'DensitySample' bytes. Only then runs of characters are skipped in bulk (kernels),
+// as the per character table loop is faster for short runs (dense escaping) and short inputs, where
+// even the sampling is not worth it:
+const std::size_t MinMeanRun = 32;
+const std::size_t DensitySample = 512;
+const std::size_t MinRunsSize = 128;
+
+// Kernels: sparse escaping check, and length of the leading run of characters copied as they are.
+// Vector implementations (x86) are selected at runtime depending on the CPU (none for scalar):
+typedef bool (*sparse_kernel_t)(const char *data, std::size_t size);
+typedef std::size_t (*run_kernel_t)(const char *data, std::size_t size);
+
+// Length of the leading run of unreserved characters
+std::size_t unreservedRunScalar(const char *data, std::size_t size)
 {
-    std::string result;
-    result.reserve(decodedUrl.length() * 3); // minimize reallocations in std::string
-    // (we multiply by 3 because it is the worst case: %XX for every character)
+    std::size_t pos = 0;
+    while (pos < size && Unreserved[(unsigned char)data[pos]]) pos++;
+    return pos;
+}
+
+// Length of the leading run of characters kept by decoder (neither '%' nor '+')
+std::size_t plainRunScalar(const char *data, std::size_t size)
+{
+    std::size_t pos = 0;
+    while (pos < size && data[pos] != '%' && data[pos] != '+') pos++;
+    return pos;
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define URL_FUNCTIONS_X86_KERNELS
+
+// Unreserved ranges (pairs) for PCMPESTRx: a-z, A-Z, 0-9, '-', '.', '_', '~'
+#define UNRESERVED_RANGES_SSE42 _mm_setr_epi8('a', 'z', 'A', 'Z', '0', '9', '-', '.', '_', '_', '~', '~', 0, 0, 0, 0)
+
+__attribute__((target("sse4.2")))
+bool sparseReservedSse42(const char *data, std::size_t size)
+{
+    const __m128i ranges = UNRESERVED_RANGES_SSE42;
+    const std::size_t limit = size / MinMeanRun;
+
+    // Stops as soon as the limit is exceeded, so dense escaping is detected on the first bytes:
+    std::size_t count = 0;
+    std::size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i mask = _mm_cmpestrm(ranges, 12, v, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY | _SIDD_BIT_MASK);
+        count += __builtin_popcount(_mm_cvtsi128_si32(mask));
+        if (count > limit) return false;
+    }
+    for (; pos < size; pos++) count += !Unreserved[(unsigned char)data[pos]];
+
+    return count <= limit;
+}
+
+__attribute__((target("sse4.2")))
+std::size_t unreservedRunSse42(const char *data, std::size_t size)
+{
+    const __m128i ranges = UNRESERVED_RANGES_SSE42;
+
+    std::size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        int index = _mm_cmpestri(ranges, 12, v, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT);
+        if (index < 16) return pos + index;
+    }
 
-    for (unsigned char c : decodedUrl) {
-        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') { // unreserved (RFC3986)
-            result += c;
+    return pos + unreservedRunScalar(data + pos, size - pos);
+}
+
+// '%' and '+' bytes mask
+__attribute__((target("sse4.2")))
+int specialsMaskSse42(const char *data)
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    return _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('%')), _mm_cmpeq_epi8(v, _mm_set1_epi8('+'))));
+}
+
+__attribute__((target("sse4.2")))
+bool sparseSpecialsSse42(const char *data, std::size_t size)
+{
+    const std::size_t limit = size / MinMeanRun;
+
+    std::size_t count = 0;
+    std::size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        count += __builtin_popcount(specialsMaskSse42(data + pos));
+        if (count > limit) return false;
+    }
+    for (; pos < size; pos++) count += (data[pos] == '%' || data[pos] == '+');
+
+    return count <= limit;
+}
+
+__attribute__((target("sse4.2")))
+std::size_t plainRunSse42(const char *data, std::size_t size)
+{
+    std::size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        int mask = specialsMaskSse42(data + pos);
+        if (mask) return pos + __builtin_ctz(mask);
+    }
+
+    return pos + plainRunScalar(data + pos, size - pos);
+}
+
+#undef UNRESERVED_RANGES_SSE42
+#endif
+
+struct Kernels {
+    sparse_kernel_t sparse_reserved; // nullptr for scalar (always table loop)
+    run_kernel_t unreserved_run;
+    sparse_kernel_t sparse_specials; // nullptr for scalar (always table loop)
+    run_kernel_t plain_run;
+};
+
+const Kernels &kernels()
+{
+    static const Kernels result = []() {
+#ifdef URL_FUNCTIONS_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse4.2")) return Kernels{sparseReservedSse42, unreservedRunSse42, sparseSpecialsSse42, plainRunSse42};
+#endif
+        return Kernels{nullptr, unreservedRunScalar, nullptr, plainRunScalar};
+    }();
+
+    return result;
+}
+
+// Encodes 'size' bytes from 'in' into 'out' (3 times 'size' available), returning the encoded size.
+// Character by character (table):
+std::size_t encodeTable(const char *in, std::size_t size, char *out)
+{
+    char *begin = out;
+
+    for (std::size_t pos = 0; pos < size; pos++) {
+        unsigned char c = in[pos];
+        if (Unreserved[c]) {
+            *out++ = c;
         } else {
             // encode as %XX
-            result += '%';
-            result += UPPER_XDIGITS[c >> 4]; // first digit
-            result += UPPER_XDIGITS[c & 0x0F]; // second digit
+            *out++ = '%';
+            *out++ = UPPER_XDIGITS[c >> 4]; // first digit
+            *out++ = UPPER_XDIGITS[c & 0x0F]; // second digit
         }
     }
 
-    return result;
+    return out - begin;
 }
 
-std::string URLFunctions::decode(const std::string& encodedUrl)
+// Idem, skipping runs of unreserved characters in bulk (sparse escaping)
+std::size_t encodeRuns(const Kernels &k, const char *in, std::size_t size, char *out)
 {
-    std::string result;
-    result.reserve(encodedUrl.size());
+    char *begin = out;
+
+    std::size_t pos = 0;
+    while (pos < size) {
+        std::size_t run = k.unreserved_run(in + pos, size - pos);
+        std::memcpy(out, in + pos, run);
+        out += run;
+        pos += run;
+        if (pos == size) break;
+
+        // encode as %XX
+        unsigned char c = in[pos++];
+        *out++ = '%';
+        *out++ = UPPER_XDIGITS[c >> 4]; // first digit
+        *out++ = UPPER_XDIGITS[c & 0x0F]; // second digit
+    }
+
+    return out - begin;
+}
+
+std::size_t encodeBuffer(const char *in, std::size_t size, char *out)
+{
+    const Kernels &k = kernels();
+    if (k.sparse_reserved && size >= MinRunsSize && k.sparse_reserved(in, std::min(size, DensitySample))) return encodeRuns(k, in, size, out);
+    return encodeTable(in, size, out);
+}
+
+// Decodes 'size' bytes from 'in' into 'out' (which may be the same buffer), returning the decoded size.
+// Character by character (table):
+std::size_t decodeTable(const char *in, std::size_t size, char *out)
+{
+    std::size_t result = 0;
 
-    for (std::size_t i = 0; i < encodedUrl.size(); ++i)
+    for (std::size_t i = 0; i < size; ++i)
     {
-        auto ch = encodedUrl[i];
+        char ch = in[i];
 
-        if (ch == '%' && (i + 2) <= encodedUrl.size())
+        if (ch == '%' && (i + 2) < size)
         {
-            auto hex = encodedUrl.substr(i + 1, 2);
-            if (std::isxdigit(hex[0]) && std::isxdigit(hex[1])) {
-                auto dec = static_cast<char>(std::strtol(hex.c_str(), nullptr, 16));
-                result.push_back(dec);
+            int high = HexValues[(unsigned char)in[i + 1]];
+            int low = HexValues[(unsigned char)in[i + 2]];
+            if (high >= 0 && low >= 0) {
+                out[result++] = static_cast<char>((high << 4) | low);
                 i += 2;
             } else {
-                result.push_back(ch);
+                out[result++] = ch;
             }
         }
         else if (ch == '+')
         {
-            result.push_back(' ');
+            out[result++] = ' ';
         }
         else
         {
-            result.push_back(ch);
+            out[result++] = ch;
         }
     }
 
     return result;
 }
 
-bool URLFunctions::matchPrefix(const std::string& urlPath,
-                               const std::string& pathPrefix)
+// Idem, skipping runs of characters kept (neither '%' nor '+') in bulk (sparse escaping)
+std::size_t decodeRuns(const Kernels &k, const char *in, std::size_t size, char *out)
 {
-    // Normalize urlPath (add slashes at both sides):
-    std::string pathNormalized = urlPath;
+    std::size_t result = 0;
 
-    if (!urlPath.empty() && urlPath.front() != '/')
+    std::size_t i = 0;
+    while (i < size)
     {
-        pathNormalized.insert(pathNormalized.begin(), '/');
+        std::size_t run = k.plain_run(in + i, size - i);
+        if (run > 0) {
+            if (out + result != in + i) std::memmove(out + result, in + i, run);
+            result += run;
+            i += run;
+            if (i == size) break;
+        }
+
+        if (in[i] == '+')
+        {
+            out[result++] = ' ';
+            i++;
+            continue;
+        }
+
+        // Escape ('%'):
+        int high = (i + 2 < size) ? HexValues[(unsigned char)in[i + 1]] : -1;
+        int low = (i + 2 < size) ? HexValues[(unsigned char)in[i + 2]] : -1;
+        if (high >= 0 && low >= 0) {
+            out[result++] = static_cast<char>((high << 4) | low);
+            i += 3;
+        } else {
+            out[result++] = in[i++];
+        }
     }
 
-    if (!urlPath.empty() && urlPath.back() != '/')
-    {
-        pathNormalized += "/";
+    return result;
+}
+
+std::size_t decodeBuffer(const char *in, std::size_t size, char *out)
+{
+    const Kernels &k = kernels();
+    if (k.sparse_specials && size >= MinRunsSize && k.sparse_specials(in, std::min(size, DensitySample))) return decodeRuns(k, in, size, out);
+    return decodeTable(in, size, out);
+}
+
+// Virtual normalization of a path (slashes added at both sides when missing, unless empty)
+struct NormalizedPath {
+    std::string_view path;
+    std::size_t front;
+    std::size_t back;
+
+    explicit NormalizedPath(std::string_view p) : path(p),
+        front(!p.empty() && p.front() != '/' ? 1 : 0),
+        back(!p.empty() && p.back() != '/' ? 1 : 0) {}
+
+    std::size_t size() const {
+        return front + path.size() + back;
     }
 
-    // Normalize pathPrefix (add slashes at both sides):
-    std::string prefixNormalized = pathPrefix;
+    char operator[](std::size_t pos) const {
+        if (pos < front) return '/';
+        pos -= front;
+        return (pos < path.size()) ? path[pos] : '/';
+    }
+};
+}
 
-    if (!pathPrefix.empty() && pathPrefix.front() != '/')
-    {
-        prefixNormalized.insert(prefixNormalized.begin(), '/');
+std::string URLFunctions::encode(std::string_view decodedUrl)
+{
+    std::string result;
+    encode(decodedUrl, result);
+    return result;
+}
+
+void URLFunctions::encode(std::string_view decodedUrl, std::string &encodedUrl)
+{
+    // Worst case is %XX for every character, so we grow once and shrink at the end:
+    std::size_t offset = encodedUrl.size();
+    encodedUrl.resize(offset + decodedUrl.size() * 3);
+    encodedUrl.resize(offset + encodeBuffer(decodedUrl.data(), decodedUrl.size(), &encodedUrl[offset]));
+}
+
+std::string URLFunctions::decode(std::string_view encodedUrl)
+{
+    std::string result;
+    decode(encodedUrl, result);
+    return result;
+}
+
+void URLFunctions::decode(std::string_view encodedUrl, std::string &decodedUrl)
+{
+    std::size_t offset = decodedUrl.size();
+    decodedUrl.resize(offset + encodedUrl.size());
+    decodedUrl.resize(offset + decodeBuffer(encodedUrl.data(), encodedUrl.size(), &decodedUrl[offset]));
+}
+
+void URLFunctions::decodeInPlace(std::string &url)
+{
+    url.resize(decodeBuffer(url.data(), url.size(), url.data()));
+}
+
+bool URLFunctions::matchPrefix(std::string_view urlPath,
+                               std::string_view pathPrefix)
+{
+    // Normalize both (add slashes at both sides) and match:
+    NormalizedPath pathNormalized(urlPath);
+    NormalizedPath prefixNormalized(pathPrefix);
+
+    if (prefixNormalized.size() > pathNormalized.size()) return false;
+
+    for (std::size_t k = 0; k < prefixNormalized.size(); k++) {
+        if (pathNormalized[k] != prefixNormalized[k]) return false;
     }
 
-    if (!pathPrefix.empty() && pathPrefix.back() != '/')
-    {
-        prefixNormalized += "/";
+    return true;
+}
+
+bool QueryTokenizer::next(std::string_view &key, std::string_view &value)
+{
+    while (pos_ < query_.size()) {
+        std::size_t end = query_.find(separator_, pos_);
+        if (end == std::string_view::npos) end = query_.size();
+
+        std::string_view token = query_.substr(pos_, end - pos_);
+        pos_ = end + 1;
+
+        if (token.empty()) continue;
+
+        std::size_t equal = token.find('=');
+        if (equal == std::string_view::npos) {
+            key = token;
+            value = std::string_view();
+        }
+        else {
+            key = token.substr(0, equal);
+            value = token.substr(equal + 1);
+        }
+
+        return true;
     }
 
-    // Match:
-    std::size_t pos = pathNormalized.find(prefixNormalized);
-    return (pos == 0);
+    return false;
 }
 
 }
@@ -0,0 +1,228 @@
+/*
+ _________________________________________________________________________________
+|             _          _     _   _        ___                                   |
+|            | |        | |   | | | |      |__ \                                  |
+|    ___ _ __| |_   __  | |__ | |_| |_ _ __   ) |   __ ___  _ __ ___  _ __ ___    |
+|   / _ \ '__| __| |__| | '_ \| __| __| '_ \ / /  / __/ _ \| '_ ` _ \| '_ ` _ \   |
+|  |  __/ |  | |_       | | | | |_| |_| |_) / /_ | (_| (_) | | | | | | | | | | |  |
+|   \___|_|   \__|      |_| |_|\__|\__| .__/____| \___\___/|_| |_| |_|_| |_| |_|  |
+|                                     | |                                         |
+|                                     |_|                                         |
+|_________________________________________________________________________________|
+
+ HTTP/2 COMM LIBRARY C++ Based in @tatsuhiro-t nghttp2 library (https://github.com/nghttp2/nghttp2)
+ Version 0.0.z
+ https://github.com/testillano/http2comm
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Eduardo Ramos
+
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <ert/http2comm/WorkStealingExecutor.hpp>
+
+namespace ert
+{
+namespace http2comm
+{
+
+WorkStealingExecutor::Queue::Queue(std::size_t capacity) : mask_([capacity]() {
+    std::size_t result = 2;
+    while (result < capacity) result <<= 1;
+    return result - 1;
+}())
+{
+    cells_ = std::make_unique<Cell[]>(mask_ + 1);
+    for (std::size_t k = 0; k <= mask_; k++) {
+        cells_[k].sequence.store(k, std::memory_order_relaxed);
+    }
+}
+
+bool WorkStealingExecutor::Queue::push(std::shared_ptr<ert::queuedispatcher::StreamIf> &stream)
+{
+    Cell *cell;
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+    for (;;) {
+        cell = &cells_[pos & mask_];
+        std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        std::intptr_t diff = (std::intptr_t)sequence - (std::intptr_t)pos;
+
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0) {
+            return false; // full
+        }
+        else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->stream = std::move(stream);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool WorkStealingExecutor::Queue::pop(std::shared_ptr<ert::queuedispatcher::StreamIf> &stream)
+{
+    Cell *cell;
+    std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+
+    for (;;) {
+        cell = &cells_[pos & mask_];
+        std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        std::intptr_t diff = (std::intptr_t)sequence - (std::intptr_t)(pos + 1);
+
+        if (diff == 0) {
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0) {
+            return false; // empty
+        }
+        else {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    stream = std::move(cell->stream);
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+}
+
+WorkStealingExecutor::WorkStealingExecutor(std::size_t threads, std::size_t queueCapacity)
+{
+    if (threads == 0) threads = 1;
+
+    for (std::size_t k = 0; k < threads; k++) {
+        workers_.push_back(std::make_unique<Worker>(queueCapacity));
+    }
+
+    for (std::size_t k = 0; k < threads; k++) {
+        workers_[k]->thread = std::thread([this, k]() {
+            run(k);
+        });
+    }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    {
+        std::lock_guard<std::mutex> guard(park_mutex_);
+        stopped_ = true;
+    }
+    park_cv_.notify_all();
+
+    for (auto &worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+void WorkStealingExecutor::dispatch(std::shared_ptr<ert::queuedispatcher::StreamIf> stream)
+{
+    // Size is increased before publishing, so it never gets negative:
+    size_.fetch_add(1);
+
+    // Round robin by dispatching thread:
+    thread_local std::size_t next{};
+    std::size_t workers = workers_.size();
+    std::size_t start = next++ % workers;
+
+    bool pushed = false;
+    for (std::size_t k = 0; k < workers && !pushed; k++) {
+        pushed = workers_[(start + k) % workers]->queue.push(stream);
+    }
+
+    if (!pushed) {
+        std::lock_guard<std::mutex> guard(overflow_mutex_);
+        overflow_.push_back(std::move(stream));
+        overflow_size_.fetch_add(1);
+    }
+
+    // Parked workers are woken up (size is checked by them under the same lock, so no wakeup is lost):
+    if (idle_.load() > 0) {
+        std::lock_guard<std::mutex> guard(park_mutex_);
+        park_cv_.notify_one();
+    }
+}
+
+bool WorkStealingExecutor::take(std::size_t index, std::shared_ptr<ert::queuedispatcher::StreamIf> &stream)
+{
+    // Own queue first, then steal from the others:
+    std::size_t workers = workers_.size();
+    for (std::size_t k = 0; k < workers; k++) {
+        if (workers_[(index + k) % workers]->queue.pop(stream)) return true;
+    }
+
+    if (overflow_size_.load() > 0) {
+        std::lock_guard<std::mutex> guard(overflow_mutex_);
+        if (!overflow_.empty()) {
+            stream = std::move(overflow_.front());
+            overflow_.pop_front();
+            overflow_size_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingExecutor::run(std::size_t index)
+{
+    const int threads = workers_.size();
+
+    while (!stopped_.load()) {
+        std::shared_ptr<ert::queuedispatcher::StreamIf> stream;
+        if (take(index, stream)) {
+            int size = size_.fetch_sub(1) - 1;
+            int busy = busy_.fetch_add(1) + 1;
+            stream->process(busy >= threads, size);
+            stream.reset();
+            busy_.fetch_sub(1);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        idle_.fetch_add(1);
+        park_cv_.wait(lock, [this]() {
+            return size_.load() > 0 || stopped_.load();
+        });
+        idle_.fetch_sub(1);
+    }
+}
+
+int WorkStealingExecutor::getBusyThreads() const
+{
+    return busy_.load(std::memory_order_relaxed);
+}
+
+int WorkStealingExecutor::getThreads() const
+{
+    return workers_.size();
+}
+
+int WorkStealingExecutor::getSize() const
+{
+    return size_.load(std::memory_order_relaxed);
+}
+
+}
+}